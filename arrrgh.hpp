@@ -29,7 +29,7 @@
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //
 //  **arrrgh** is a fast, small, simple, powerful, single-header library for parsing command line arguments in C++
-//  using more-or-less POSIX parsing rules.
+//  using more-or-less POSIX parsing rules. It requires C++17.
 //
 //  To use:
 //
@@ -68,16 +68,80 @@
 //
 //  		Use try...catch... if you want to catch problems in a healthy way.
 //
+//  		Or call parser.try_parse( argc, argv ), which returns an arrrgh::parse_status instead of throwing;
+//  		parser.error_message( status ) describes a failure. It works with exceptions disabled.
+//
+//  		parse() copies the argument text. If argv will outlive the values you read, parse( argc, argv,
+//  		arrrgh::Borrow ) keeps views into argv instead; read them with value_view() and
+//  		each_unlabeled_argument_view().
+//
+//  		Call parser.expand_response_files() before parsing to accept "@path" arguments naming files of further
+//  		arguments, one per line.
+//
+//  		To reuse the parser, call parser.clear_values() between parses. The parser takes all of its memory from
+//  		an optional std::pmr::memory_resource given to its constructor.
+//
 //  	6.	Access argument values:
 //
-//  			myArgument.value()		// Returns a float if we templated on <float>.
+//  			myArgument.value()		// Returns a const float& if we templated on <float>.
 //
-//  		try...catch... helps here too because users may give invalid strings for non-string types.
+//  		Values are converted once, by parse(), so this is cheap enough to call in a loop. Invalid strings for
+//  		non-string types make parse() throw.
 //
 //  	7.	Call parser.show_usage() if you want to print help text.
 //
 //  	8.	Do other stuff. See "Example usage" below for "unlabeled" arguments, the "--" marker, and such.
 //
+//  	9.	To use your own value type, specialize arrrgh::type_traits for it (see arrrgh::type_traits below).
+//
+//  	10.	If your whole option set is known at compile time, arrrgh::static_parser does the same job with no
+//  		per-option allocation or runtime setup. See static_parser below.
+//
+//  	11.	To parse on several threads at once, build an arrrgh::schema (add() works the same) and share it.
+//  		schema.parse( argc, argv ) returns a parse_result; read values with result.value( myArgument ).
+//  		schema.parse_batch() parses many command lines across a pool of threads.
+//
+//  	12.	If a whole command line arrives as one string, arrrgh::tokenizer splits it with shell quoting rules into
+//  		an argc/argv that parse() accepts. See tokenizer below.
+//
+//  	13.	With parser.expand_response_files(), an "@path" argument is replaced by the entries of the file at path:
+//  		one per line, or separated by NULs (as from find -print0) if the file contains any.
+//
+//  	14.	parser.stream_unlabeled_arguments( sink ) hands each unlabeled argument to sink as soon as it's parsed,
+//  		instead of storing it.
+//
+//  	15.	Define ARRRGH_ENABLE_STATS as 1 before including this header, and parser.stats() reports where parse
+//  		time goes. Without it, the instrumentation compiles away.
+//
+//  	16.	An argument whose type is a std::vector collects every appearance of its switch (-I a -I b). A vector
+//  		of numbers also takes comma-separated lists (--weights=1.5,2,3).
+//
+//  	17.	parser.try_parse( argc, argv ) reports errors as a parse_status instead of throwing (see step 5).
+//
+//  	18.	parser.add_subcommand( name, description, addArguments ) makes a git-style subcommand, with its own
+//  		parser that is only built when the subcommand is used.
+//
+//  	19.	parser.bind_environment( argument, variable ) and parser.bind_environment_prefix( prefix ) let
+//  		environment variables supply values that the command line doesn't.
+//
+//  	20.	parser.set_config_file( path ) reads defaults from "key = value" lines. Pass true as well to keep the
+//  		converted values in a cache beside the file.
+//
+//  	21.	parser.allow_abbreviations() accepts a unique prefix of a long form. parser.complete( argc, argv )
+//  		answers shell completion queries.
+//
+//  	22.	An unrecognized long form is reported with the nearest long forms as suggestions.
+//
+//  	23.	arrrgh::live_options wraps a schema whose values change while the program runs; threads read snapshots
+//  		of it without waiting.
+//
+//  	24.	To take an enum by name, specialize arrrgh::choice_traits with a table of its names and values.
+//
+//  	25.	parser.saved_values() is a compact binary copy of the parsed values, which parser.load_values() in
+//  		another process assigns without parsing the command line again.
+//
+//  	README.md says more about each of these.
+//
 //  Example usage:
 //
 //  ------------------------------------------------------------------------------------------------------------------
@@ -150,15 +214,104 @@
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <cassert>
 #include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <functional>
 #include <iomanip>
 #include <iostream>
+#include <limits>
+#include <locale>
 #include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <numeric>
 #include <sstream>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
+#if defined( __SSE2__ ) || defined( _M_X64 )
+#	include <emmintrin.h>
+#	define ARRRGH_SSE2 1
+#else
+#	define ARRRGH_SSE2 0
+#endif
+
+#if ( defined( __BYTE_ORDER__ ) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__ ) || defined( _M_X64 ) || defined( _M_IX86 ) || defined( _M_ARM64 )
+#	define ARRRGH_LITTLE_ENDIAN 1
+#else
+#	define ARRRGH_LITTLE_ENDIAN 0
+#endif
+
+// Define ARRRGH_ENABLE_STATS as 1 before including this header to have parser record where its parse time goes
+// (see parse_stats). Otherwise the instrumentation compiles to nothing.
+//
+#ifndef ARRRGH_ENABLE_STATS
+#	define ARRRGH_ENABLE_STATS 0
+#endif
+
+// The setting changes parser's layout and code, so everything is declared in an inline namespace named for it.
+// Translation units that disagree on it then use distinct types, which fail to link together rather than
+// silently mixing the two.
+//
+#if ARRRGH_ENABLE_STATS
+#	define ARRRGH_STATS( statement ) statement
+#	define ARRRGH_STATS_TIMER( counter ) detail::stats_timer statsTimer{ counter }
+#	define ARRRGH_CONFIG_NAMESPACE with_stats
+#else
+#	define ARRRGH_STATS( statement )
+#	define ARRRGH_STATS_TIMER( counter )
+#	define ARRRGH_CONFIG_NAMESPACE without_stats
+#endif
+
+#if defined( __unix__ ) || defined( __APPLE__ )
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#	define ARRRGH_MMAP 1
+#else
+#	define ARRRGH_MMAP 0
+#endif
+
+#if defined( _WIN32 )
+#	include <process.h>
+#endif
+
+// Floating-point std::from_chars is missing from some standard libraries (libc++ before 17, and Apple's), which
+// don't advertise __cpp_lib_to_chars. Those read floating-point values with a classic-locale istringstream
+// instead. Define ARRRGH_FLOAT_FROM_CHARS as 0 or 1 to choose.
+//
+#ifndef ARRRGH_FLOAT_FROM_CHARS
+#	if defined( __cpp_lib_to_chars ) && __cpp_lib_to_chars >= 201611L
+#		define ARRRGH_FLOAT_FROM_CHARS 1
+#	else
+#		define ARRRGH_FLOAT_FROM_CHARS 0
+#	endif
+#endif
+
+#if !defined( _WIN32 )
+extern "C" char** environ;
+#endif
+
 namespace arrrgh
+{
+inline namespace ARRRGH_CONFIG_NAMESPACE
 {
 	// Utility functions and macros.
 	//
@@ -173,604 +326,5646 @@ namespace arrrgh
 #define ARRRGH_EXCEPTION( exception_class ) \
 	struct exception_class : public std::runtime_error { using runtime_error::runtime_error;  };
 	
+	// Builds without exceptions (-fno-exceptions) abort where they would have thrown. parser::try_parse() reports
+	// parse errors without needing either.
+	//
+#if defined( __cpp_exceptions ) || defined( __EXCEPTIONS ) || defined( _CPPUNWIND )
+#	define ARRRGH_THROW( ... ) throw __VA_ARGS__
+#	define ARRRGH_TRY try
+#	define ARRRGH_CATCH_ALL catch( ... )
+#	define ARRRGH_RETHROW throw
+#else
+#	define ARRRGH_THROW( ... ) ( static_cast< void >( __VA_ARGS__ ), std::abort() )
+#	define ARRRGH_TRY if( true )
+#	define ARRRGH_CATCH_ALL else
+#	define ARRRGH_RETHROW
+#endif
+	
 	enum Requirement
 	{
 		Optional,
 		Required
 	};
 	
-	template< typename ValueT >
+	// What parser::parse() does with argv.
+	//
+	enum Ownership
+	{
+		Copy,		// Copies the argument text, so argv may be discarded after parsing.
+		Borrow		// Keeps views into argv, which must outlive the parsed values. Allocates nothing for string data.
+	};
+	
+	// A view of a contiguous run of T.
+	//
+	template< typename T >
+	class span
+	{
+	public:
+		span() = default;
+		
+		span( T* data, size_t size )
+		:	m_data( data )
+		,	m_size( size )
+		{}
+		
+		template< typename Container, typename = decltype( std::declval< Container& >().data() ) >
+		span( Container& container )
+		:	span( container.data(), container.size() )
+		{}
+		
+		T* data() const { return m_data; }
+		size_t size() const { return m_size; }
+		bool empty() const { return m_size == 0; }
+		T* begin() const { return m_data; }
+		T* end() const { return m_data + m_size; }
+		T& operator[]( size_t i ) const { assert( i < m_size ); return m_data[ i ]; }
+		
+	private:
+		T* m_data = nullptr;
+		size_t m_size = 0;
+	};
+	
+	// One program's arguments, as given to main().
+	//
+	struct command_line
+	{
+		int argc;
+		const char* const* argv;
+	};
+	
+	// What parser::stats() reports when ARRRGH_ENABLE_STATS is on: totals since the parser was made or
+	// reset_stats() was last called. Times are in nanoseconds.
+	//
+	struct parse_stats
+	{
+		uint64_t parses = 0;
+		uint64_t totalNanoseconds = 0;			// All of parse(), including the phases below.
+		uint64_t copyNanoseconds = 0;			// Copying argv (arrrgh::Copy).
+		uint64_t lookupNanoseconds = 0;			// Finding the argument for each switch.
+		uint64_t assignNanoseconds = 0;			// Recording each switch's value.
+		uint64_t conversionNanoseconds = 0;		// Converting values to their arguments' types.
+		uint64_t validationNanoseconds = 0;		// Checking for required arguments.
+		
+		uint64_t tokens = 0;					// Arguments scanned, including response file entries.
+		uint64_t lookupProbes = 0;				// Index entries examined while finding arguments.
+		uint64_t bytesCopied = 0;				// Argument text copied by arrrgh::Copy.
+		uint64_t allocations = 0;				// Allocations parse() made from the parser's memory resource.
+		uint64_t conversionFailures = 0;
+	};
+	
+	// Why parser::try_parse() failed. Each corresponds to the exception parser::parse() throws in its place.
+	//
+	enum class parse_error : uint8_t
+	{
+		none,
+		no_arguments,					// InvalidParameters
+		unknown_argument,				// UnknownArgument
+		invalid_argument_character,		// InvalidArgumentCharacter
+		missing_value,					// argument_abstract::MissingValue
+		value_conversion,				// argument< T >::ValueConversionError
+		missing_required_arguments,		// MissingRequiredArguments
+		unreadable_response_file,		// UnreadableResponseFile
+		unknown_subcommand,				// UnknownSubcommand
+		unreadable_config_file,			// UnreadableConfigFile
+		malformed_config_line,			// MalformedConfigFile
+		unknown_config_key,				// UnknownArgument
+		ambiguous_argument,				// AmbiguousArgument
+		unreadable_saved_values,		// UnreadableSavedValues
+		mismatched_saved_values,		// MismatchedSavedValues
+	};
+	
+	// What parser::try_parse() returns: true if the parse succeeded. Otherwise argumentIndex is the argv index of
+	// the argument at fault (-1 if it's no one argument's fault) and offset is where in that argument the trouble
+	// starts--or, for an entry of a response file, where in the file. parser::error_message() says more.
+	//
+	struct parse_status
+	{
+		parse_error error = parse_error::none;
+		int argumentIndex = -1;
+		uint32_t offset = 0;
+		
+		explicit operator bool() const
+		{
+			return error == parse_error::none;
+		}
+	};
+	
+	template< typename ValueT, typename = void >
 	struct type_traits
 	{
 		static constexpr bool always_requires_value() { return false; }
 		static constexpr const char* name();
 	};
 	
-	// argument classes.
+	// Specialize for an enum to take its values by name ("--compression=zstd"):
 	//
-	class argument_abstract
+	//		namespace arrrgh
+	//		{
+	//			template<>
+	//			struct choice_traits< compression >
+	//			{
+	//				static constexpr std::array< std::pair< std::string_view, compression >, 3 > choices{{
+	//					{ "zstd", compression::zstd }, { "lz4", compression::lz4 }, { "none", compression::none } }};
+	//			};
+	//		}
+	//
+	// parse() then converts a name to its value once, through a hash table built at compile time, and
+	// value() is the enum. Names must be unique and not empty. The usage line lists them, and so does the error
+	// for a value that isn't one of them.
+	//
+	template< typename ValueT >
+	struct choice_traits {};
+	
+	// Implementation details shared by parser and static_parser.
+	//
+	namespace detail
 	{
-	public:
+		constexpr bool is_letter( char c )
+		{
+			return ( c >= 'a' && c <= 'z' ) || ( c >= 'A' && c <= 'Z' );
+		}
 		
-		ARRRGH_EXCEPTION( MissingValue )
-		ARRRGH_EXCEPTION( Nameless )
+		// FNV-1a. Usable at compile time for static_parser's matching tables.
+		//
+		constexpr uint64_t hash( std::string_view s )
+		{
+			uint64_t result = 14695981039346656037ull;
+			for( const char c : s )
+			{
+				result ^= static_cast< unsigned char >( c );
+				result *= 1099511628211ull;
+			}
+			return result;
+		}
 		
-		std::string best_name() const
+		// A fast hash of a block of memory, eight bytes at a time, for noticing that a file has changed.
+		//
+		inline uint64_t hash_bytes( const char* data, size_t size )
 		{
-			if( m_longForm.empty() )
+			uint64_t result = 0x9E3779B97F4A7C15ull ^ size;
+			for( ; size >= 8; data += 8, size -= 8 )
 			{
-				return std::string{ m_letter };
+				uint64_t word;
+				std::memcpy( &word, data, 8 );
+				result = ( result ^ word ) * 0xFF51AFD7ED558CCDull;
+				result ^= result >> 32;
 			}
-			else
+			
+			uint64_t tail = 0;
+			if( size > 0 )
 			{
-				return m_longForm;
+				std::memcpy( &tail, data, size );
 			}
+			result = ( result ^ tail ) * 0xC4CEB9FE1A85EC53ull;
+			return result ^ ( result >> 29 );
 		}
 		
-		bool assigned() const
+		// Numbers are read with std::from_chars (see number_from_chars()), which never touches the locale. Like the istream extraction it
+		// replaces, leading whitespace and a leading '+' are skipped and anything after the number is ignored.
+		//
+		inline const char* skip_number_prefix( const char* first, const char* last )
 		{
-			return m_assigned;
+			while( first != last && ( *first == ' ' || ( *first >= '\t' && *first <= '\r' )))
+			{
+				++first;
+			}
+			if( first != last && *first == '+' )
+			{
+				++first;
+			}
+			return first;
 		}
 		
-		const std::string& value_string() const
+		// std::from_chars for any number type, including floating-point ones where the library lacks them.
+		//
+		template< typename ValueT >
+		std::from_chars_result number_from_chars( const char* first, const char* last, ValueT& result )
 		{
-			return m_value;
+#if !ARRRGH_FLOAT_FROM_CHARS
+			if constexpr( std::is_floating_point< ValueT >::value )
+			{
+				// As from_chars does: no whitespace or '+' first, and the result says where the number ends.
+				//
+				if( first == last || *first == '+' || *first == ' ' || ( *first >= '\t' && *first <= '\r' ))
+				{
+					return { first, std::errc::invalid_argument };
+				}
+				
+				std::istringstream stream( std::string( first, last ));
+				stream.imbue( std::locale::classic() );
+				stream >> result;
+				if( stream.fail() )
+				{
+					return { first, std::errc::invalid_argument };
+				}
+				return { stream.eof() ? last : first + static_cast< std::streamoff >( stream.tellg() ), std::errc{} };
+			}
+			else
+#endif
+			{
+				return std::from_chars( first, last, result );
+			}
 		}
 		
-		void clear_value()
+		template< typename ValueT >
+		bool parse_number( const char* first, const char* last, ValueT& result )
 		{
-			m_assigned = false;
-			m_value.clear();
+			first = skip_number_prefix( first, last );
+			return number_from_chars( first, last, result ).ec == std::errc{};
 		}
-
-		// FOR TESTING.
-		// Gets the string value of the argument as a result of its conversion to the
-		// templated value_t for that particular argument subclass.
+		
+		template< typename ValueT >
+		struct is_vector : std::false_type {};
+		
+		template< typename ValueT >
+		struct is_vector< std::vector< ValueT >> : std::true_type {};
+		
+		template< typename ValueT, typename = void >
+		struct has_choices : std::false_type {};
+		
+		template< typename ValueT >
+		struct has_choices< ValueT, std::void_t< decltype( choice_traits< ValueT >::choices ) >> : std::true_type {};
+		
+		// For a type with choice_traits, its names joined with '|', and the name of value. Empty otherwise.
 		//
-		virtual std::string converted_value_string() const = 0;
-		virtual bool has_default_value() const = 0;
+		template< typename ValueT >
+		std::string_view allowed_values();
 		
-	protected:
+		template< typename ValueT >
+		std::string_view choice_name( const ValueT& value );
 		
-		bool m_assigned;
+		template< typename ValueT, typename = void >
+		struct is_equality_comparable : std::false_type {};
 		
-		explicit argument_abstract( const std::string& longForm,
-								    const std::string& explanation,
-								    char letter,
-								    Requirement required )
-		:	m_assigned( false )
-		,	m_longForm( longForm )
-		,	m_explanation( explanation )
-		,	m_letter( letter )
-		,	m_requirement( required )
-		{
-			assert( !m_longForm.empty() || m_letter != '\0' );		// Gotta specify at least one.
-			assert( m_longForm.empty() || m_longForm[ 0 ] != '-' );	// Don't start your switch names with -.
-			assert( m_letter == '\0' || is_valid_short_form( m_letter ));	// Has to be valid or nothing.
-		}
+		template< typename ValueT >
+		struct is_equality_comparable< ValueT, std::void_t< decltype( std::declval< const ValueT& >() == std::declval< const ValueT& >() )>>
+		:	std::true_type {};
 		
-		bool has_long_form( const std::string& longForm ) const
-		{
-			return !m_longForm.empty() && m_longForm == longForm;
-		}
+		template< typename ValueT >
+		struct is_number_list : std::false_type {};
 		
-		bool has_short_form( char shortForm ) const
+		template< typename ValueT >
+		struct is_number_list< std::vector< ValueT >>
+		:	std::integral_constant< bool, std::is_arithmetic< ValueT >::value && !std::is_same< ValueT, bool >::value > {};
+		
+		inline unsigned int lowest_set_bit( unsigned int mask )
 		{
-			return m_letter != '\0' && m_letter == shortForm;
+#if defined( __GNUC__ )
+			return static_cast< unsigned int >( __builtin_ctz( mask ));
+#else
+			unsigned int index = 0;
+			for( ; ( mask & 1 ) == 0; mask >>= 1 )
+			{
+				++index;
+			}
+			return index;
+#endif
 		}
-
-		bool required() const
+		
+		// Calls fn( first, last ) for each comma-separated element of [first, last), stopping if it returns false.
+		// Returns the start of the element that stopped it, or nullptr. With SSE2, each 16-byte load finds every
+		// comma in it, so short elements cost no more than a bit scan each.
+		//
+		template< typename Function >
+		const char* each_list_element( const char* first, const char* const last, Function&& fn )
 		{
-			return m_requirement == Required;
+			const char* elementBegin = first;
+			const char* p = first;
+#if ARRRGH_SSE2
+			const __m128i comma = _mm_set1_epi8( ',' );
+			
+			for( ; last - p >= 16; p += 16 )
+			{
+				const __m128i chunk = _mm_loadu_si128( reinterpret_cast< const __m128i* >( p ));
+				unsigned int mask = static_cast< unsigned int >( _mm_movemask_epi8( _mm_cmpeq_epi8( chunk, comma )));
+				
+				for( ; mask != 0; mask &= mask - 1 )
+				{
+					const char* const delimiter = p + lowest_set_bit( mask );
+					if( !fn( elementBegin, delimiter ))
+					{
+						return elementBegin;
+					}
+					elementBegin = delimiter + 1;
+				}
+			}
+#endif
+			for( ; p != last; ++p )
+			{
+				if( *p == ',' )
+				{
+					if( !fn( elementBegin, p ))
+					{
+						return elementBegin;
+					}
+					elementBegin = p + 1;
+				}
+			}
+			return fn( elementBegin, last ) ? nullptr : elementBegin;
 		}
 		
-		virtual bool required_value() const = 0;
-
-		void assign( const std::string& givenKey, std::string&& valueString )
+		// Converts the run of 1 to 8 decimal digits that ends at last, all eight bytes at a time within one 64-bit
+		// register. The eight bytes before last must be readable. Returns false if any of the digits isn't one.
+		//
+		inline bool parse_eight_digits( const char* last, const size_t length, uint32_t& result )
 		{
-			m_assigned = true;
+			assert( length > 0 && length <= 8 );
+			
+			// Load the eight bytes ending with the digits and replace those before them with zeros. The first
+			// byte lands in the lowest bits, so the digits end up right-aligned behind the zeros.
+			//
+			uint64_t chunk;
+			std::memcpy( &chunk, last - 8, 8 );
 			
-			m_value = std::move( valueString );
+			const uint64_t digitMask = ~0ull << ( 8 * ( 8 - length ));
+			chunk = ( chunk & digitMask ) | ( 0x3030303030303030ull & ~digitMask );
 			
-			if( m_value.empty() && required_value() )
+			// Each byte must be 0x30 to 0x39.
+			//
+			if((( chunk & 0xF0F0F0F0F0F0F0F0ull ) | ((( chunk + 0x0606060606060606ull ) & 0xF0F0F0F0F0F0F0F0ull ) >> 4 ))
+			   != 0x3333333333333333ull )
 			{
-				throw MissingValue{ arrrgh_collect_string( "Argument required a value but received none." ) };
+				return false;
 			}
+			
+			chunk -= 0x3030303030303030ull;
+			chunk = (( chunk * 10 ) + ( chunk >> 8 )) & 0x00FF00FF00FF00FFull;
+			chunk = (( chunk * 100 ) + ( chunk >> 16 )) & 0x0000FFFF0000FFFFull;
+			chunk = (( chunk * 10000 ) + ( chunk >> 32 )) & 0x00000000FFFFFFFFull;
+			
+			result = static_cast< uint32_t >( chunk );
+			return true;
 		}
-								
-		void print( std::ostream& out ) const
+		
+		// One element of a number list, which starts at or after listFirst. Unlike parse_number(), the whole element
+		// must be the number.
+		//
+		template< typename ValueT >
+		bool parse_list_number( const char* const listFirst, const char* first, const char* last, ValueT& result )
 		{
-			out << "    ";
+			first = skip_number_prefix( first, last );
 			
-			bool hasLetter = m_letter != '\0';
-			if( hasLetter )
+#if ARRRGH_LITTLE_ENDIAN
+			// Most integers in a list are short, so skip from_chars() for those of up to eight digits--all but
+			// those in the list's first eight bytes, where there's not room to load eight at once.
+			//
+			if constexpr( std::is_integral< ValueT >::value )
 			{
-				out << "-" << m_letter;
+				const bool negative = std::is_signed< ValueT >::value && first != last && *first == '-';
+				const char* const digits = first + negative;
+				const size_t length = last - digits;
+				
+				uint32_t magnitude;
+				if( length > 0 && length <= 8 && last - listFirst >= 8 && parse_eight_digits( last, length, magnitude ))
+				{
+					typedef typename std::make_unsigned< ValueT >::type unsigned_t;
+					const uint64_t limit = static_cast< uint64_t >( static_cast< unsigned_t >( std::numeric_limits< ValueT >::max() )) + negative;
+					
+					if( magnitude > limit )
+					{
+						return false;
+					}
+					result = static_cast< ValueT >( negative ? 0 - static_cast< unsigned_t >( magnitude ) : magnitude );
+					return true;
+				}
 			}
+#endif
+			const auto converted = number_from_chars( first, last, result );
+			return converted.ec == std::errc{} && converted.ptr == last;
+		}
+		
+		// Appends each comma-separated number in [first, last) to result. If one doesn't convert, returns its start
+		// and leaves result as it was. Returns nullptr otherwise.
+		//
+		template< typename ValueT >
+		const char* parse_number_list( const char* first, const char* last, std::vector< ValueT >& result )
+		{
+			const size_t sizeBefore = result.size();
 			
-			bool hasLong = !m_longForm.empty();
-			
-			if( hasLetter && hasLong )
+			const char* const failed = each_list_element( first, last, [&]( const char* elementFirst, const char* elementLast )
+														  {
+															  ValueT element;
+															  if( !parse_list_number( first, elementFirst, elementLast, element ))
+															  {
+																  return false;
+															  }
+															  result.push_back( element );
+															  return true;
+														  } );
+			if( failed )
 			{
-				out << ", ";
+				result.resize( sizeBefore );
 			}
-			
-			if( hasLong )
+			return failed;
+		}
+		
+		// The element of a number list in text that doesn't convert, or all of text if it's not a list of numbers.
+		//
+		template< typename ValueT >
+		std::string_view unconverted_part( std::string_view text )
+		{
+			if constexpr( is_number_list< ValueT >::value )
 			{
-				out << "--" << m_longForm;
+				typedef typename ValueT::value_type element_t;
+				
+				const char* const last = text.data() + text.size();
+				const char* const failed = each_list_element( text.data(), last, [&]( const char* elementFirst, const char* elementLast )
+															  {
+																  element_t element;
+																  return parse_list_number( text.data(), elementFirst, elementLast, element );
+															  } );
+				if( failed )
+				{
+					const char* const failedEnd = std::find( failed, last, ',' );
+					return std::string_view( failed, static_cast< size_t >( failedEnd - failed ));
+				}
 			}
-			
-			if( required_value() )
+			return text;
+		}
+		
+		// "Could not convert value..." for value, where part is the portion of it at fault, listing the allowed
+		// values if there's a list of them.
+		//
+		inline std::string conversion_error_message( std::string_view value, std::string_view part, std::string_view allowed = {} )
+		{
+			std::ostringstream message;
+			if( part.size() == value.size() )
 			{
-				out << "=<" << value_type_name() << ">";
+				message << "Could not convert value '" << value << "' to the desired argument type.";
 			}
-			
-			out << "\n\t\t";
-			
-			if( m_requirement == Required )
+			else
 			{
-				out << "[required] ";
+				const size_t index = std::count( value.data(), part.data(), ',' );
+				message << "Could not convert element " << index << " ('" << part << "') of value '" << value
+						<< "' to the desired argument type.";
 			}
 			
-			out << m_explanation;
+			if( !allowed.empty() )
+			{
+				message << " Expected one of " << allowed << ".";
+			}
+			return message.str();
 		}
-
-		static bool is_valid_short_form( char c )
+		
+		// Accepts true/false, yes/no, on/off and 1/0.
+		//
+		inline bool parse_bool( const char* first, const char* last, bool& result )
 		{
-			return std::isalpha( c );
+			struct word { const char* text; size_t length; bool value; };
+			static constexpr word words[] = {
+				{ "true", 4, true }, { "false", 5, false },
+				{ "yes", 3, true }, { "no", 2, false },
+				{ "on", 2, true }, { "off", 3, false },
+				{ "1", 1, true }, { "0", 1, false } };
+			
+			const size_t length = static_cast< size_t >( last - first );
+			for( const auto& candidate : words )
+			{
+				if( candidate.length == length && std::memcmp( candidate.text, first, length ) == 0 )
+				{
+					result = candidate.value;
+					return true;
+				}
+			}
+			return false;
 		}
 		
-		virtual std::string value_type_name() const = 0;
+		template< typename ValueT, typename = void >
+		struct has_parse : std::false_type {};
 		
-	private:
+		template< typename ValueT >
+		struct has_parse< ValueT, std::void_t< decltype( type_traits< ValueT >::parse( std::declval< const char* >(),
+																					  std::declval< const char* >(),
+																					  std::declval< ValueT& >() )) >>
+		:	std::true_type {};
 		
-		std::string m_longForm;
-		std::string m_explanation;
+		// Uses type_traits< ValueT >::parse() where there is one. Other types fall back to operator>>.
+		//
+		template< typename ValueT >
+		bool convert( std::string_view text, ValueT& result )
+		{
+			if constexpr( has_parse< ValueT >::value )
+			{
+				return type_traits< ValueT >::parse( text.data(), text.data() + text.size(), result );
+			}
+			else
+			{
+				std::istringstream stream( std::string{ text } );
+				stream >> std::boolalpha >> result;
+				return !stream.fail();
+			}
+		}
+		
+		inline void print_usage_line( std::ostream& out,
+									  char letter,
+									  std::string_view longForm,
+									  bool requiresValue,
+									  const char* valueTypeName,
+									  Requirement requirement,
+									  std::string_view explanation )
+		{
+			out << "    ";
+			
+			bool hasLetter = letter != '\0';
+			if( hasLetter )
+			{
+				out << "-" << letter;
+			}
+			
+			bool hasLong = !longForm.empty();
+			
+			if( hasLetter && hasLong )
+			{
+				out << ", ";
+			}
+			
+			if( hasLong )
+			{
+				out << "--" << longForm;
+			}
+			
+			if( requiresValue )
+			{
+				out << "=<" << valueTypeName << ">";
+			}
+			
+			out << "\n\t\t";
+			
+			if( requirement == Required )
+			{
+				out << "[required] ";
+			}
+			
+			out << explanation;
+		}
+		
+		// Interprets one argument using the POSIX-style rules, reporting to the handler:
+		//
+		//		handler.long_form( key, value )		for "--key" and "--key=value"
+		//		handler.letter( letter, value )		for each letter of "-abc" and "-c=value"
+		//		handler.invalid_letter( letter )	for a non-letter in a short-form cluster
+		//		handler.unlabeled( arg )			for everything else, including all arguments after "--"
+		//
+		// Each is a view into arg (letter is a single character), so a handler can tell where in arg it is.
+		// value is empty when no "=" was given. Each handler function returns false to stop scanning, in which
+		// case scan_argument() returns false too.
+		//
+		// doneWithSwitches carries the "--" state from one argument to the next: when false, still looking for
+		// switches; when true, all arguments are considered "unlabeled."
+		//
+		template< typename Handler >
+		bool scan_argument( const std::string_view arg, bool& doneWithSwitches, Handler& handler )
+		{
+			// Do we have a leading hyphen?
+			//
+			if( !doneWithSwitches && !arg.empty() && arg[ 0 ] == '-' )
+			{
+				// Yes we do.
+				
+				// Do we have two?
+				//
+				if( arg.size() > 1 && arg[ 1 ] == '-' )
+				{
+					// Yes. So we're expecting a long-form argument.
+					
+					// Read to the end or to the = sign.
+					//
+					const auto keyEnd = arg.find( '=' );
+					
+					const auto key = arg.substr( 2, keyEnd - 2 );
+					
+					std::string_view value;
+					
+					if( keyEnd < arg.size() )
+					{
+						value = arg.substr( keyEnd + 1 );
+					}
+					
+					if( key.empty() )
+					{
+						// This is either "--" or, more troublingly, "--=..."
+						
+						// Either way, don't look for arguments any more:
+						// anything else is "unlabeled."
+						//
+						doneWithSwitches = true;
+						return true;
+					}
+					
+					return handler.long_form( key, value );
+				}
+				else
+				{
+					// No we don't. Just one.
+					
+					// Consider each following letter to be a short-form argument letter.
+					//
+					for( size_t j = 1; j < arg.size(); ++j )
+					{
+						const char c = arg[ j ];
+						
+						// Is this a reasonable argument character?
+						//
+						if( is_letter( c ))
+						{
+							// This is a legitimate argument.
+							
+							// Does it have a value?
+							//
+							std::string_view value;
+							bool hasAssignment = j + 1 < arg.size() && arg[ j + 1 ] == '=';
+							if( hasAssignment )
+							{
+								// Looks like it. Read it.
+								//
+								value = arg.substr( j + 2 );
+							}
+							
+							if( !handler.letter( arg.substr( j, 1 ), value ))
+							{
+								return false;
+							}
+							
+							if( hasAssignment )
+							{
+								break;
+							}
+						}
+						else if( !handler.invalid_letter( arg.substr( j, 1 )))
+						{
+							return false;
+						}
+					}
+					
+					return true;
+				}
+			}
+			else
+			{
+				// No we don't. This is an unlabeled argument.
+				//
+				return handler.unlabeled( arg );
+			}
+		}
+		
+		// Walks argv[ 1 ] onward with scan_argument(), until the handler says to stop.
+		//
+		template< typename Handler >
+		bool scan_arguments( const int argc, const char* const argv[], Handler&& handler )
+		{
+			bool doneWithSwitches = false;
+			
+			for( int i = 1; i < argc; ++i )
+			{
+				assert( argv[ i ] );
+				if( !scan_argument( argv[ i ], doneWithSwitches, handler ))
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+		
+		// The process's environment: "NAME=value" strings, ending with nullptr.
+		//
+		inline const char* const* process_environment()
+		{
+#if defined( _WIN32 )
+			return _environ;
+#else
+			return environ;
+#endif
+		}
+		
+		// This process's ID, or 0 where it isn't known.
+		//
+		inline long process_id()
+		{
+#if defined( _WIN32 )
+			return _getpid();
+#elif ARRRGH_MMAP
+			return static_cast< long >( ::getpid() );
+#else
+			return 0;
+#endif
+		}
+		
+		// A response file's contents, mapped copy-on-write so that entries can be unquoted in place without
+		// touching the file. Where mmap isn't available, the file is read into memory instead.
+		//
+		class mapped_file
+		{
+		public:
+			
+			mapped_file() = default;
+			mapped_file( const mapped_file& ) = delete;
+			mapped_file& operator=( const mapped_file& ) = delete;
+			
+			~mapped_file()
+			{
+#if ARRRGH_MMAP
+				if( m_size > 0 )
+				{
+					::munmap( m_data, m_size );
+				}
+#else
+				delete[] m_data;
+#endif
+			}
+			
+			bool open( const char* path )
+			{
+				assert( !m_data );
+#if ARRRGH_MMAP
+				const int fd = ::open( path, O_RDONLY );
+				if( fd < 0 )
+				{
+					return false;
+				}
+				
+				const bool succeeded = open_descriptor( fd );
+				::close( fd );
+				return succeeded;
+#else
+				std::FILE* const file = std::fopen( path, "rb" );
+				if( !file )
+				{
+					return false;
+				}
+				
+				bool succeeded = std::fseek( file, 0, SEEK_END ) == 0;
+				const long size = succeeded ? std::ftell( file ) : -1;
+				succeeded = size >= 0 && std::fseek( file, 0, SEEK_SET ) == 0;
+				if( succeeded && size > 0 )
+				{
+					m_data = new char[ size ];
+					m_size = size;
+					succeeded = std::fread( m_data, 1, m_size, file ) == m_size;
+				}
+				
+				std::fclose( file );
+				return succeeded;
+#endif
+			}
+			
+			// Maps the file that descriptor refers to, from its start, leaving the descriptor open. Where there's
+			// no mmap, descriptors aren't supported and this returns false.
+			//
+			bool open_descriptor( int descriptor )
+			{
+				assert( !m_data );
+#if ARRRGH_MMAP
+				struct stat status;
+				bool succeeded = ::fstat( descriptor, &status ) == 0;
+				if( succeeded && status.st_size > 0 )
+				{
+					void* const data = ::mmap( nullptr, status.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, descriptor, 0 );
+					succeeded = data != MAP_FAILED;
+					if( succeeded )
+					{
+						m_data = static_cast< char* >( data );
+						m_size = status.st_size;
+					}
+				}
+				m_modified = succeeded ? static_cast< int64_t >( status.st_mtime ) : 0;
+				return succeeded;
+#else
+				static_cast< void >( descriptor );
+				return false;
+#endif
+			}
+			
+			char* data() const
+			{
+				return m_data;
+			}
+			
+			size_t size() const
+			{
+				return m_size;
+			}
+			
+			// When the file was last modified, in seconds, or 0 where that's not known.
+			//
+			int64_t modification_time() const
+			{
+				return m_modified;
+			}
+			
+		private:
+			
+			char* m_data = nullptr;
+			size_t m_size = 0;
+			int64_t m_modified = 0;
+		};
+		
+		// Calls fn( entry ) for each entry of a response file. Entries are separated by NULs if the file contains any
+		// and by newlines (with or without a carriage return) otherwise. Empty entries are skipped. An entry wrapped in
+		// matching quotes has them removed, and inside "double quotes", a backslash escapes the next character; this
+		// unquoting is done in place.
+		//
+		template< typename Function >
+		void each_response_file_entry( char* data, const size_t size, Function&& fn )
+		{
+			const char delimiter = std::memchr( data, '\0', size ) ? '\0' : '\n';
+			
+			char* p = data;
+			char* const end = data + size;
+			
+			while( p != end )
+			{
+				char* entryEnd = static_cast< char* >( std::memchr( p, delimiter, end - p ));
+				char* const next = entryEnd ? entryEnd + 1 : end;
+				if( !entryEnd )
+				{
+					entryEnd = end;
+				}
+				
+				if( delimiter == '\n' && entryEnd != p && entryEnd[ -1 ] == '\r' )
+				{
+					--entryEnd;
+				}
+				
+				const size_t length = entryEnd - p;
+				
+				if( length >= 2 && ( *p == '"' || *p == '\'' ) && entryEnd[ -1 ] == *p )
+				{
+					const char quote = *p;
+					const char* const contentEnd = entryEnd - 1;
+					
+					char* out = p;
+					for( const char* in = p + 1; in != contentEnd; ++in )
+					{
+						if( quote == '"' && *in == '\\' && in + 1 != contentEnd )
+						{
+							++in;
+						}
+						*out++ = *in;
+					}
+					
+					fn( std::string_view{ p, static_cast< size_t >( out - p ) } );
+				}
+				else if( length > 0 )
+				{
+					fn( std::string_view{ p, length } );
+				}
+				
+				p = next;
+			}
+		}
+		
+		inline std::string_view trim_whitespace( std::string_view text )
+		{
+			const auto isSpace = []( char c ) { return c == ' ' || c == '\t' || c == '\r'; };
+			
+			while( !text.empty() && isSpace( text.front() ))
+			{
+				text.remove_prefix( 1 );
+			}
+			while( !text.empty() && isSpace( text.back() ))
+			{
+				text.remove_suffix( 1 );
+			}
+			return text;
+		}
+		
+		// Calls fn( line ) for each line of a config file, trimmed of surrounding whitespace (and any carriage
+		// return), stopping early if fn returns false. Returns false if it stopped early.
+		//
+		template< typename Function >
+		bool each_config_line( const char* data, const size_t size, Function&& fn )
+		{
+			const char* p = data;
+			const char* const end = data + size;
+			
+			while( p != end )
+			{
+				const char* lineEnd = static_cast< const char* >( std::memchr( p, '\n', end - p ));
+				const char* const next = lineEnd ? lineEnd + 1 : end;
+				if( !lineEnd )
+				{
+					lineEnd = end;
+				}
+				
+				if( !fn( trim_whitespace( std::string_view{ p, static_cast< size_t >( lineEnd - p ) } )))
+				{
+					return false;
+				}
+				p = next;
+			}
+			return true;
+		}
+		
+		// Splits a trimmed config file line, "key = value", into its key and value. A value wrapped in matching
+		// quotes has them removed. Returns false if the line has no '=' or no key.
+		//
+		inline bool split_config_line( std::string_view line, std::string_view& key, std::string_view& value )
+		{
+			const size_t equals = line.find( '=' );
+			if( equals == std::string_view::npos )
+			{
+				return false;
+			}
+			
+			key = trim_whitespace( line.substr( 0, equals ));
+			value = trim_whitespace( line.substr( equals + 1 ));
+			
+			if( value.size() >= 2 && ( value.front() == '"' || value.front() == '\'' ) && value.back() == value.front() )
+			{
+				value = value.substr( 1, value.size() - 2 );
+			}
+			return !key.empty();
+		}
+		
+		// A trie over a set of names, for finding all of those that start with a prefix. It's laid out flat: the
+		// children of each node are adjacent in one array, in order of their labels, so a lookup reads a few short
+		// runs of memory. Each node covers a range of the names in sorted order, those that start with the path to
+		// it, so the matches for a prefix come out as a range without visiting the subtree.
+		//
+		template< typename ValueT >
+		class name_trie
+		{
+		public:
+			
+			typedef std::pair< std::string_view, ValueT > entry;
+			
+			explicit name_trie( std::pmr::memory_resource* resource )
+			:	m_entries( resource )
+			,	m_nodes( resource )
+			,	m_scratch( resource )
+			{}
+			
+			// Replaces the names, which must outlive the trie, with those in [first, last), and rebuilds it.
+			//
+			template< typename Iterator >
+			void build( Iterator first, Iterator last )
+			{
+				m_entries.assign( first, last );
+				
+				m_nodes.clear();
+				m_nodes.push_back( node{ 0, static_cast< uint32_t >( m_entries.size() ), 0, 0, 0, '\0' } );
+				
+				// Breadth first, so that each node's children are made together. Sorting each node's names by
+				// their next letter as it's made (a radix sort) is much quicker than sorting them whole up front,
+				// since names often share long prefixes.
+				//
+				for( size_t i = 0; i < m_nodes.size(); ++i )
+				{
+					const node parent = m_nodes[ i ];
+					const uint32_t depth = parent.depth;
+					
+					// Names that end here come first.
+					//
+					const auto endsHere = [&]( const entry& e ) { return e.first.size() == depth; };
+					const auto letterAt = [&]( const entry& e ) { return static_cast< unsigned char >( e.first[ depth ] ); };
+					
+					auto begin = std::partition( m_entries.begin() + parent.begin, m_entries.begin() + parent.end, endsHere );
+					const auto end = m_entries.begin() + parent.end;
+					
+					const bool mixed = begin != end && std::any_of( begin + 1, end, [&]( const entry& e ) { return letterAt( e ) != letterAt( *begin ); } );
+					
+					if( mixed && end - begin > 64 )
+					{
+						// A counting sort, for the many names near the root.
+						//
+						uint32_t counts[ 257 ] = {};
+						std::for_each( begin, end, [&]( const entry& e ) { ++counts[ letterAt( e ) + 1 ]; } );
+						std::partial_sum( counts, counts + 257, counts );
+						
+						m_scratch.resize( end - begin );
+						std::for_each( begin, end, [&]( const entry& e ) { m_scratch[ counts[ letterAt( e ) ]++ ] = e; } );
+						std::copy( m_scratch.begin(), m_scratch.end(), begin );
+					}
+					else if( mixed )
+					{
+						std::sort( begin, end, [&]( const entry& a, const entry& b ) { return letterAt( a ) < letterAt( b ); } );
+					}
+					
+					const uint32_t firstChild = static_cast< uint32_t >( m_nodes.size() );
+					while( begin != end )
+					{
+						const unsigned char letter = letterAt( *begin );
+						const auto next = std::find_if( begin + 1, end, [&]( const entry& e ) { return letterAt( e ) != letter; } );
+						
+						m_nodes.push_back( node{ static_cast< uint32_t >( begin - m_entries.begin() ),
+												 static_cast< uint32_t >( next - m_entries.begin() ),
+												 0,
+												 0,
+												 depth + 1,
+												 static_cast< char >( letter ) } );
+						begin = next;
+					}
+					
+					m_nodes[ i ].firstChild = firstChild;
+					m_nodes[ i ].childCount = static_cast< uint32_t >( m_nodes.size() ) - firstChild;
+				}
+			}
+			
+			// The entries whose names start with prefix, in order of their names.
+			//
+			std::pair< const entry*, const entry* > starting_with( std::string_view prefix ) const
+			{
+				if( m_nodes.empty() )
+				{
+					return {};
+				}
+				
+				const node* current = &m_nodes[ 0 ];
+				for( const char c : prefix )
+				{
+					const node* child = m_nodes.data() + current->firstChild;
+					const node* const childrenEnd = child + current->childCount;
+					while( child != childrenEnd && child->label != c )
+					{
+						++child;
+					}
+					
+					if( child == childrenEnd )
+					{
+						return {};
+					}
+					current = child;
+				}
+				return { m_entries.data() + current->begin, m_entries.data() + current->end };
+			}
+			
+			size_t size() const
+			{
+				return m_entries.size();
+			}
+			
+			// Walks the trie depth first. Below the root, whose state is root, descend( state, letter ) is called
+			// for each node with a copy of its parent's state, to update for the node's letter, and returns whether
+			// to go on into the node's subtree. visit( state, entry ) is called for each node gone into where a
+			// name ends.
+			//
+			template< typename State, typename Descend, typename Visit >
+			void walk( const State& root, Descend&& descend, Visit&& visit ) const
+			{
+				if( !m_nodes.empty() )
+				{
+					walk_from( m_nodes[ 0 ], root, descend, visit );
+				}
+			}
+			
+		private:
+			
+			struct node;
+			
+			template< typename State, typename Descend, typename Visit >
+			void walk_from( const node& current, const State& state, Descend& descend, Visit& visit ) const
+			{
+				if( current.begin != current.end && m_entries[ current.begin ].first.size() == current.depth )
+				{
+					visit( state, m_entries[ current.begin ] );
+				}
+				
+				const node* const children = m_nodes.data() + current.firstChild;
+				for( uint32_t i = 0; i < current.childCount; ++i )
+				{
+					State childState = state;
+					if( descend( childState, children[ i ].label ))
+					{
+						walk_from( children[ i ], childState, descend, visit );
+					}
+				}
+			}
+			
+			struct node
+			{
+				uint32_t begin;			// The range of m_entries starting with the path to this node.
+				uint32_t end;
+				uint32_t firstChild;
+				uint32_t childCount;
+				uint32_t depth;
+				char label;
+			};
+			
+			std::pmr::vector< entry > m_entries;
+			std::pmr::vector< node > m_nodes;
+			std::pmr::vector< entry > m_scratch;
+		};
+		
+		// Levenshtein distances from one pattern of up to 64 characters, computed a column at a time with the
+		// bit-parallel algorithm of Myers, as adapted by Hyyro for whole-string distance. Each column is the
+		// distances from each prefix of the pattern to the text so far, kept as bit vectors of the +1 and -1
+		// differences between adjacent ones, so adding a text character costs a dozen word operations however
+		// long the pattern is.
+		//
+		class edit_distance_pattern
+		{
+		public:
+			
+			struct column
+			{
+				uint64_t positive;		// Bit i set if row i + 1 is one more than row i.
+				uint64_t negative;		// ...one less.
+				uint32_t distance;		// The last row: the distance from the whole pattern to the text so far.
+				uint32_t textLength;
+			};
+			
+			static constexpr size_t maxLength = 64;
+			
+			explicit edit_distance_pattern( std::string_view pattern )
+			:	m_length( static_cast< uint32_t >( pattern.size() ))
+			{
+				assert( pattern.size() <= maxLength && !pattern.empty() );
+				
+				for( size_t i = 0; i < pattern.size(); ++i )
+				{
+					m_matches[ static_cast< unsigned char >( pattern[ i ] ) ] |= uint64_t( 1 ) << i;
+				}
+			}
+			
+			// The column for empty text: the distance from each prefix is its length.
+			//
+			column start() const
+			{
+				return column{ m_length == 64 ? ~uint64_t( 0 ) : ( uint64_t( 1 ) << m_length ) - 1, 0, m_length, 0 };
+			}
+			
+			column step( const column& previous, char c ) const
+			{
+				const uint64_t lastRow = uint64_t( 1 ) << ( m_length - 1 );
+				const uint64_t matches = m_matches[ static_cast< unsigned char >( c ) ];
+				
+				const uint64_t vertical = matches | previous.negative;
+				const uint64_t horizontal = ((( matches & previous.positive ) + previous.positive ) ^ previous.positive ) | matches;
+				uint64_t horizontalPositive = previous.negative | ~( horizontal | previous.positive );
+				uint64_t horizontalNegative = previous.positive & horizontal;
+				
+				column result = previous;
+				result.distance += ( horizontalPositive & lastRow ) != 0;
+				result.distance -= ( horizontalNegative & lastRow ) != 0;
+				++result.textLength;
+				
+				horizontalPositive = ( horizontalPositive << 1 ) | 1;	// The empty prefix is always one further.
+				horizontalNegative <<= 1;
+				
+				result.positive = horizontalNegative | ~( vertical | horizontalPositive );
+				result.negative = horizontalPositive & vertical;
+				return result;
+			}
+			
+			// The least distance from any prefix of the pattern to the text so far, below which no text that starts
+			// with it can come.
+			//
+			uint32_t lower_bound( const column& current ) const
+			{
+				int32_t row = static_cast< int32_t >( current.textLength );
+				int32_t least = row;
+				for( uint32_t i = 0; i < m_length; ++i )
+				{
+					row += static_cast< int32_t >(( current.positive >> i ) & 1 ) - static_cast< int32_t >(( current.negative >> i ) & 1 );
+					least = std::min( least, row );
+				}
+				return static_cast< uint32_t >( least );
+			}
+			
+			// The distance to text, or a number above limit if it's sure to be more than limit.
+			//
+			uint32_t distance( std::string_view text, uint32_t limit ) const
+			{
+				column current = start();
+				for( size_t i = 0; i < text.size(); ++i )
+				{
+					current = step( current, text[ i ] );
+					
+					// Each character left can lower the distance by one at most.
+					//
+					if( current.distance > limit + ( text.size() - i - 1 ))
+					{
+						return limit + 1;
+					}
+				}
+				return current.distance;
+			}
+			
+			// How far off a name can be to be suggested for this one.
+			//
+			uint32_t suggestion_limit() const
+			{
+				return std::min< uint32_t >( 3, std::max< uint32_t >( 1, ( m_length + 1 ) / 3 ));
+			}
+			
+		private:
+			
+			uint64_t m_matches[ 256 ] = {};
+			uint32_t m_length;
+		};
+		
+		// The few names closest to an unknown one, nearest first, without allocating.
+		//
+		class suggestion_list
+		{
+		public:
+			
+			static constexpr size_t capacity = 3;
+			
+			void offer( std::string_view name, uint32_t distance )
+			{
+				size_t i = m_count < capacity ? m_count++ : capacity;
+				for( ; i > 0 && ( m_distances[ i - 1 ] > distance || ( m_distances[ i - 1 ] == distance && m_names[ i - 1 ] > name )); --i )
+				{
+					if( i < capacity )
+					{
+						m_names[ i ] = m_names[ i - 1 ];
+						m_distances[ i ] = m_distances[ i - 1 ];
+					}
+				}
+				
+				if( i < capacity )
+				{
+					m_names[ i ] = name;
+					m_distances[ i ] = distance;
+				}
+			}
+			
+			void clear()
+			{
+				m_count = 0;
+			}
+			
+			bool empty() const
+			{
+				return m_count == 0;
+			}
+			
+			const std::string_view* begin() const
+			{
+				return m_names;
+			}
+			
+			const std::string_view* end() const
+			{
+				return m_names + m_count;
+			}
+			
+			// Ends an error message with " Did you mean "--a", "--b" or "--c"?", naming those that are nearest, if
+			// there are any.
+			//
+			void print( std::ostream& out, std::string_view prefix ) const
+			{
+				const size_t nearest = std::count( m_distances, m_distances + m_count, m_distances[ 0 ] );
+				for( size_t i = 0; i < nearest; ++i )
+				{
+					out << ( i == 0 ? " Did you mean \"" : i + 1 == nearest ? " or \"" : ", \"" ) << prefix << m_names[ i ] << '"';
+				}
+				if( nearest > 0 )
+				{
+					out << '?';
+				}
+			}
+			
+		private:
+			
+			std::string_view m_names[ capacity ];
+			uint32_t m_distances[ capacity ] = {};
+			size_t m_count = 0;
+		};
+		
+#if ARRRGH_ENABLE_STATS
+		// Adds the time between its construction and destruction to counter.
+		//
+		class stats_timer
+		{
+		public:
+			
+			explicit stats_timer( uint64_t& counter )
+			:	m_counter( counter )
+			,	m_start( std::chrono::steady_clock::now() )
+			{}
+			
+			~stats_timer()
+			{
+				m_counter += std::chrono::duration_cast< std::chrono::nanoseconds >(
+					std::chrono::steady_clock::now() - m_start ).count();
+			}
+			
+		private:
+			
+			uint64_t& m_counter;
+			const std::chrono::steady_clock::time_point m_start;
+		};
+		
+		// Counts allocations on their way to another resource.
+		//
+		class counting_resource : public std::pmr::memory_resource
+		{
+		public:
+			
+			counting_resource( std::pmr::memory_resource* upstream, uint64_t& allocations )
+			:	m_upstream( upstream )
+			,	m_allocations( allocations )
+			{}
+			
+		private:
+			
+			std::pmr::memory_resource* m_upstream;
+			uint64_t& m_allocations;
+			
+			virtual void* do_allocate( size_t bytes, size_t alignment ) override
+			{
+				++m_allocations;
+				return m_upstream->allocate( bytes, alignment );
+			}
+			
+			virtual void do_deallocate( void* p, size_t bytes, size_t alignment ) override
+			{
+				m_upstream->deallocate( p, bytes, alignment );
+			}
+			
+			virtual bool do_is_equal( const std::pmr::memory_resource& other ) const noexcept override
+			{
+				return this == &other;
+			}
+		};
+#endif
+		
+		constexpr bool is_shell_space( char c )
+		{
+			return c == ' ' || ( c >= '\t' && c <= '\r' );
+		}
+		
+		// Returns the first byte in [p, end) that the shell treats specially--outside quotes, whitespace, quotes and
+		// backslash; inside double quotes, '"' and backslash--or end. Scans 16 bytes at a time where SSE2 is
+		// available, since most of a command line is ordinary text.
+		//
+		inline const char* find_shell_special( const char* p, const char* const end, bool inDoubleQuotes )
+		{
+#if ARRRGH_SSE2
+			const __m128i quote = _mm_set1_epi8( '"' );
+			const __m128i backslash = _mm_set1_epi8( '\\' );
+			const __m128i apostrophe = _mm_set1_epi8( '\'' );
+			const __m128i space = _mm_set1_epi8( ' ' );
+			const __m128i tab = _mm_set1_epi8( '\t' );
+			const __m128i lastControlSpace = _mm_set1_epi8( '\r' - '\t' );
+			
+			for( ; end - p >= 16; p += 16 )
+			{
+				const __m128i chunk = _mm_loadu_si128( reinterpret_cast< const __m128i* >( p ));
+				__m128i hits = _mm_or_si128( _mm_cmpeq_epi8( chunk, quote ), _mm_cmpeq_epi8( chunk, backslash ));
+				
+				if( !inDoubleQuotes )
+				{
+					// '\t' through '\r' is one unsigned range: ( c - '\t' ) <= ( '\r' - '\t' ).
+					//
+					const __m128i fromTab = _mm_sub_epi8( chunk, tab );
+					const __m128i controlSpace = _mm_cmpeq_epi8( _mm_min_epu8( fromTab, lastControlSpace ), fromTab );
+					
+					hits = _mm_or_si128( hits, _mm_or_si128( _mm_cmpeq_epi8( chunk, apostrophe ),
+															 _mm_or_si128( _mm_cmpeq_epi8( chunk, space ), controlSpace )));
+				}
+				
+				unsigned int mask = static_cast< unsigned int >( _mm_movemask_epi8( hits ));
+				if( mask != 0 )
+				{
+					while(( mask & 1 ) == 0 )
+					{
+						mask >>= 1;
+						++p;
+					}
+					return p;
+				}
+			}
+#endif
+			for( ; p != end; ++p )
+			{
+				const char c = *p;
+				if( c == '"' || c == '\\' || ( !inDoubleQuotes && ( c == '\'' || is_shell_space( c ))))
+				{
+					break;
+				}
+			}
+			return p;
+		}
+	}
+	
+	///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	
+	// Splits a whole command line held in one string into arguments, following POSIX shell quoting:
+	//
+	//	-	Unquoted whitespace separates arguments.
+	//	-	'single quotes' keep everything inside them literally.
+	//	-	"double quotes" keep everything literally except \", \\, \$, \` and \<newline>.
+	//	-	Outside quotes, a backslash keeps the next character literally (and \<newline> disappears).
+	//
+	// Quotes are removed, and quoted and unquoted parts that touch make one argument. Expansions ($var, globs,
+	// ~ and the like) are not performed.
+	//
+	// The arguments are written into one buffer that the tokenizer reuses, so after the first few command lines
+	// tokenizing allocates nothing:
+	//
+	//		arrrgh::tokenizer tokenizer;
+	//		const auto commandLine = tokenizer.tokenize( "my-prog --name=\"Absolom, Absolom\" -f" );
+	//		parser.parse( commandLine.argc, commandLine.argv );
+	//
+	class tokenizer
+	{
+	public:
+		
+		ARRRGH_EXCEPTION( UnterminatedQuote )
+		
+		explicit tokenizer( std::pmr::memory_resource* resource = std::pmr::get_default_resource() )
+		:	m_text( resource )
+		,	m_arguments( resource )
+		{}
+		
+		// The returned arguments point into the tokenizer and stay valid until the next tokenize().
+		//
+		command_line tokenize( std::string_view commandLine )
+		{
+			// Removing quotes and escapes never lengthens an argument, and every argument but the last is followed
+			// by at least one separator to make room for its terminator, so this is enough for any command line.
+			//
+			if( m_text.size() < commandLine.size() + 1 )
+			{
+				m_text.resize( commandLine.size() + 1 );
+			}
+			
+			m_arguments.clear();
+			
+			const char* p = commandLine.data();
+			const char* const end = p + commandLine.size();
+			char* out = &m_text[ 0 ];
+			
+			for( ;; )
+			{
+				while( p != end && detail::is_shell_space( *p ))
+				{
+					++p;
+				}
+				
+				if( p == end )
+				{
+					break;
+				}
+				
+				m_arguments.push_back( out );
+				
+				// Copy runs of ordinary bytes wholesale, dealing with quotes and escapes in between.
+				//
+				for( ;; )
+				{
+					const char* special = detail::find_shell_special( p, end, false );
+					out = std::copy( p, special, out );
+					p = special;
+					
+					if( p == end || detail::is_shell_space( *p ))
+					{
+						break;
+					}
+					
+					const char c = *p++;
+					
+					if( c == '\\' )
+					{
+						if( p == end )
+						{
+							*out++ = c;		// A backslash at the very end stands for itself.
+						}
+						else if( *p++ != '\n' )
+						{
+							*out++ = p[ -1 ];
+						}
+					}
+					else if( c == '\'' )
+					{
+						const char* close = static_cast< const char* >( std::memchr( p, '\'', end - p ));
+						if( !close )
+						{
+							ARRRGH_THROW( UnterminatedQuote{ arrrgh_collect_string( "Unterminated ' in command line." ) } );
+						}
+						
+						out = std::copy( p, close, out );
+						p = close + 1;
+					}
+					else
+					{
+						assert( c == '"' );
+						
+						for( ;; )
+						{
+							special = detail::find_shell_special( p, end, true );
+							out = std::copy( p, special, out );
+							p = special;
+							
+							if( p == end )
+							{
+								ARRRGH_THROW( UnterminatedQuote{ arrrgh_collect_string( "Unterminated \" in command line." ) } );
+							}
+							
+							if( *p++ == '"' )
+							{
+								break;
+							}
+							
+							// A backslash in double quotes only escapes these. Otherwise it stands for itself.
+							//
+							if( p != end && ( *p == '"' || *p == '\\' || *p == '$' || *p == '`' || *p == '\n' ))
+							{
+								if( *p != '\n' )
+								{
+									*out++ = *p;
+								}
+								++p;
+							}
+							else
+							{
+								*out++ = '\\';
+							}
+						}
+					}
+				}
+				
+				*out++ = '\0';
+			}
+			
+			return { static_cast< int >( m_arguments.size() ), m_arguments.data() };
+		}
+		
+	private:
+		
+		std::pmr::string m_text;
+		std::pmr::vector< const char* > m_arguments;
+	};
+	
+	// argument classes.
+	//
+	class argument_abstract
+	{
+	public:
+		
+		ARRRGH_EXCEPTION( MissingValue )
+		ARRRGH_EXCEPTION( Nameless )
+		
+		virtual ~argument_abstract() {}
+		
+		std::string best_name() const
+		{
+			if( m_longForm.empty() )
+			{
+				return std::string{ m_letter };
+			}
+			else
+			{
+				return std::string{ m_longForm };
+			}
+		}
+		
+		bool assigned() const
+		{
+			return m_assigned;
+		}
+		
+		std::string value_string() const
+		{
+			return std::string{ m_value };
+		}
+		
+		// A view of the assigned text. It points into argv when parsed with arrrgh::Borrow and into the parser's
+		// own copy otherwise.
+		//
+		std::string_view value_view() const
+		{
+			return m_value;
+		}
+		
+		virtual void clear_value()
+		{
+			m_assigned = false;
+			m_value = {};
+		}
+
+		// FOR TESTING.
+		// Gets the string value of the argument as a result of its conversion to the
+		// templated value_t for that particular argument subclass.
+		//
+		virtual std::string converted_value_string() const = 0;
+		virtual bool has_default_value() const = 0;
+		
+	protected:
+		
+		bool m_assigned;
+		
+		explicit argument_abstract( std::string_view longForm,
+								    std::string_view explanation,
+								    char letter,
+								    Requirement required,
+								    std::pmr::memory_resource* resource )
+		:	m_assigned( false )
+		,	m_longForm( longForm, resource )
+		,	m_explanation( explanation, resource )
+		,	m_letter( letter )
+		,	m_requirement( required )
+		{
+			assert( !m_longForm.empty() || m_letter != '\0' );		// Gotta specify at least one.
+			assert( m_longForm.empty() || m_longForm[ 0 ] != '-' );	// Don't start your switch names with -.
+			assert( m_letter == '\0' || is_valid_short_form( m_letter ));	// Has to be valid or nothing.
+		}
+		
+		bool has_long_form( std::string_view longForm ) const
+		{
+			return !m_longForm.empty() && m_longForm == longForm;
+		}
+		
+		bool has_short_form( char shortForm ) const
+		{
+			return m_letter != '\0' && m_letter == shortForm;
+		}
+
+		bool required() const
+		{
+			return m_requirement == Required;
+		}
+		
+		virtual bool required_value() const = 0;
+		
+		// Destroys this argument and returns its memory to the resource that parser::add() allocated it from.
+		//
+		virtual void destroy( std::pmr::memory_resource* resource ) = 0;
+		
+		// Typed value storage outside the argument, as used by batch_result. The slot is value_size() bytes
+		// aligned to value_alignment(). store_value() constructs the value first unless constructed is true,
+		// then converts text into it, returning false if it doesn't convert (the value stays constructed).
+		//
+		virtual size_t value_size() const = 0;
+		virtual size_t value_alignment() const = 0;
+		virtual bool value_is_trivial() const = 0;
+		virtual bool store_value( void* slot, std::string_view text, bool constructed ) const = 0;
+		virtual void destroy_value( void* slot ) const = 0;
+		
+		// For values that can be saved as their bytes and restored from them (numbers, and vectors of numbers):
+		// value_bytes() views those of a stored value and returns true, and restore_value() converts from them as
+		// from the text that gave them: it sets a number and appends to a vector. Used by the config file cache.
+		//
+		virtual bool value_bytes( const void* slot, std::string_view& bytes ) const = 0;
+		virtual void restore_value( std::string_view bytes ) = 0;
+		
+		// Whether two stored values are equal, where nullptr stands for the default. Values of a type without ==
+		// are taken to differ.
+		//
+		virtual bool same_value( const void* a, const void* b ) const = 0;
+		
+		// Identifies how value_bytes() lays a value out (0 if it doesn't), so that bytes saved for one type are
+		// never restored into another with the same name and size.
+		//
+		virtual uint64_t value_layout() const = 0;
+		
+		// Calls fn( text ) with text that converts back to the argument's value: once for a single value, and once
+		// per element, in order, for a vector. Used for values without value_bytes(), by parser::saved_values().
+		//
+		virtual void each_value_text( const std::function< void( std::string_view ) >& fn ) const = 0;
+		
+		// The argument's value, as a slot for the functions above.
+		//
+		virtual const void* value_slot() const = 0;
+		
+		// Converts the assigned value string to the argument's type and caches the result.
+		// Returns false if the string doesn't convert.
+		//
+		virtual bool convert_value( Ownership ownership ) = 0;
+		
+		// The part of text, which didn't convert, at fault: the bad element of a list, or else all of it.
+		//
+		virtual std::string_view unconverted_part( std::string_view text ) const = 0;
+		
+		// Throws the ValueConversionError of the argument's type, with message.
+		//
+		virtual void throw_conversion_error( std::string message ) const = 0;
+		
+		void throw_conversion_error_for( std::string_view text ) const
+		{
+			throw_conversion_error( detail::conversion_error_message( text, unconverted_part( text ), allowed_values() ));
+		}
+		
+		// For an argument of choices, their names joined with '|'. Empty otherwise.
+		//
+		virtual std::string_view allowed_values() const = 0;
+
+		// Returns false if the argument needs a value and valueString is empty. It counts as assigned either way.
+		//
+		bool assign( std::string_view valueString )
+		{
+			m_assigned = true;
+			
+			m_value = valueString;
+			
+			return !( m_value.empty() && required_value() );
+		}
+		
+		static void throw_missing_value()
+		{
+			ARRRGH_THROW( MissingValue{ arrrgh_collect_string( "Argument required a value but received none." ) } );
+		}
+								
+		void print( std::ostream& out ) const
+		{
+			detail::print_usage_line( out,
+									  m_letter,
+									  m_longForm,
+									  required_value(),
+									  value_type_name(),
+									  m_requirement,
+									  m_explanation );
+		}
+
+		static bool is_valid_short_form( char c )
+		{
+			return detail::is_letter( c );
+		}
+		
+		virtual const char* value_type_name() const = 0;
+		
+	private:
+		
+		std::pmr::string m_longForm;
+		std::pmr::string m_explanation;
 		char m_letter;
 		Requirement m_requirement;
+		uint32_t m_index = 0;		// Where it is in its schema's arguments, for saving and caching values.
+		
+		std::string_view m_value;
+		
+		friend class schema;
+		friend class parser;
+		friend class batch_result;
+		friend class parse_result;
+		friend class live_options;
+	};
+	
+	///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	
+	template< typename ValueType >
+	class argument : public argument_abstract
+	{
+	public:
+		typedef ValueType value_t;
+		
+		// Exception types.
+		//
+		ARRRGH_EXCEPTION( ValueConversionError )
+
+		operator value_t() const
+		{
+			return value();
+		}
+		
+		// The value is converted once, when parsed, so reading it is cheap.
+		//
+		const value_t& value() const
+		{
+			return m_assigned ? m_convertedValue : m_defaultValue;
+		}
+		
+		// For std::vector arguments: the collected values, without a copy. The span is good until the next parse
+		// or clear_values(). Not for std::vector< bool >, which has no contiguous storage to view: read value()
+		// instead (value().size() is the count of "-vvv").
+		//
+		template< typename V = value_t,
+				  typename = std::enable_if_t< detail::is_vector< V >::value && !std::is_same< V, std::vector< bool >>::value >>
+		span< const typename V::value_type > values() const
+		{
+			const value_t& v = value();
+			return { v.data(), v.size() };
+		}
+		
+		// For std::vector arguments: makes room for count values, so that collecting that many doesn't reallocate.
+		// clear_values() keeps the room for the next parse.
+		//
+		template< typename V = value_t, typename = std::enable_if_t< detail::is_vector< V >::value >>
+		void reserve( size_t count )
+		{
+			m_convertedValue.reserve( count );
+		}
+		
+		virtual void clear_value() override
+		{
+			argument_abstract::clear_value();
+			
+			if constexpr( detail::is_vector< value_t >::value )
+			{
+				m_convertedValue.clear();
+			}
+		}
+		
+	private:
+		
+		value_t m_defaultValue = value_t{};
+		value_t m_convertedValue = value_t{};
+
+		explicit argument( std::string_view longForm,
+						   std::string_view explanation,
+						   char letter,
+						   Requirement required,
+						   const value_t& defaultValue,
+						   std::pmr::memory_resource* resource )
+		:	argument_abstract( longForm, explanation, letter, required, resource )
+		,	m_defaultValue( defaultValue )
+		{}
+		
+		virtual void destroy( std::pmr::memory_resource* resource ) override
+		{
+			std::pmr::polymorphic_allocator< argument > allocator{ resource };
+			this->~argument();
+			allocator.deallocate( this, 1 );
+		}
+		
+		virtual const char* value_type_name() const override
+		{
+			return type_traits< value_t >::name();
+		}
+		
+		virtual std::string converted_value_string() const override
+		{
+			std::ostringstream stream;
+			stream << std::boolalpha;
+			
+			if constexpr( detail::is_vector< value_t >::value )
+			{
+				const char* separator = "";
+				for( const auto& element : value() )
+				{
+					if constexpr( detail::has_choices< typename value_t::value_type >::value )
+					{
+						stream << separator << detail::choice_name( element );
+					}
+					else
+					{
+						stream << separator << element;
+					}
+					separator = ",";
+				}
+			}
+			else if constexpr( detail::has_choices< value_t >::value )
+			{
+				stream << detail::choice_name( value() );
+			}
+			else
+			{
+				stream << value();
+			}
+			return stream.str();
+		}
+		
+		virtual bool has_default_value() const override
+		{
+			return value() == m_defaultValue;
+		}
+		
+		virtual bool required_value() const override
+		{
+			return type_traits< value_t >::always_requires_value();
+		}
+		
+		static bool convert( std::string_view text, value_t& result )
+		{
+			return detail::convert( text, result );
+		}
+		
+		virtual bool convert_value( Ownership ) override
+		{
+			return convert( value_view(), m_convertedValue );
+		}
+		
+		virtual std::string_view unconverted_part( std::string_view text ) const override
+		{
+			return detail::unconverted_part< value_t >( text );
+		}
+		
+		virtual void throw_conversion_error( std::string message ) const override
+		{
+			ARRRGH_THROW( ValueConversionError{ std::move( message ) } );
+		}
+		
+		virtual std::string_view allowed_values() const override
+		{
+			if constexpr( detail::is_vector< value_t >::value )
+			{
+				return detail::allowed_values< typename value_t::value_type >();
+			}
+			return detail::allowed_values< value_t >();
+		}
+		
+		virtual size_t value_size() const override
+		{
+			return sizeof( value_t );
+		}
+		
+		virtual size_t value_alignment() const override
+		{
+			return alignof( value_t );
+		}
+		
+		virtual bool value_is_trivial() const override
+		{
+			return std::is_trivially_destructible< value_t >::value;
+		}
+		
+		virtual bool store_value( void* slot, std::string_view text, bool constructed ) const override
+		{
+			if( !constructed )
+			{
+				new( slot ) value_t{};
+			}
+			return convert( text, *static_cast< value_t* >( slot ));
+		}
+		
+		virtual void destroy_value( void* slot ) const override
+		{
+			static_cast< value_t* >( slot )->~value_t();
+		}
+		
+		virtual bool value_bytes( const void* slot, std::string_view& bytes ) const override
+		{
+			if constexpr( std::is_arithmetic< value_t >::value )
+			{
+				bytes = std::string_view( static_cast< const char* >( slot ), sizeof( value_t ));
+				return true;
+			}
+			else if constexpr( detail::is_number_list< value_t >::value )
+			{
+				const value_t& values = *static_cast< const value_t* >( slot );
+				bytes = std::string_view( reinterpret_cast< const char* >( values.data() ),
+										  values.size() * sizeof( typename value_t::value_type ));
+				return true;
+			}
+			return false;
+		}
+		
+		virtual void restore_value( std::string_view bytes ) override
+		{
+			if constexpr( std::is_arithmetic< value_t >::value )
+			{
+				assert( bytes.size() == sizeof( value_t ));
+				std::memcpy( &m_convertedValue, bytes.data(), sizeof( value_t ));
+			}
+			else if constexpr( detail::is_number_list< value_t >::value )
+			{
+				const size_t count = m_convertedValue.size();
+				m_convertedValue.resize( count + bytes.size() / sizeof( typename value_t::value_type ));
+				std::memcpy( m_convertedValue.data() + count, bytes.data(), bytes.size() );
+			}
+			else
+			{
+				assert( false );
+			}
+		}
+		
+		virtual const void* value_slot() const override
+		{
+			return &value();
+		}
+		
+		virtual void each_value_text( const std::function< void( std::string_view ) >& fn ) const override
+		{
+			const auto text = [&]( const auto& element )
+			{
+				using element_t = std::decay_t< decltype( element ) >;
+				
+				if constexpr( std::is_same< element_t, std::string >::value || std::is_same< element_t, std::string_view >::value )
+				{
+					fn( element );
+				}
+				else if constexpr( detail::has_choices< element_t >::value )
+				{
+					fn( detail::choice_name( element ));
+				}
+				else if constexpr( std::is_same< element_t, bool >::value )
+				{
+					fn( element ? "true" : "false" );
+				}
+				else
+				{
+					std::ostringstream stream;
+					stream << element;
+					fn( stream.str() );
+				}
+			};
+			
+			if constexpr( detail::is_vector< value_t >::value )
+			{
+				for( const auto& element : value() )
+				{
+					text( element );
+				}
+			}
+			else if constexpr( std::is_same< value_t, std::string >::value ||
+							   std::is_same< value_t, std::string_view >::value ||
+							   detail::has_choices< value_t >::value )
+			{
+				text( value() );
+			}
+			else
+			{
+				fn( value_view() );		// Just as it was given.
+			}
+		}
+		
+		virtual bool same_value( const void* a, const void* b ) const override
+		{
+			if constexpr( detail::is_equality_comparable< value_t >::value )
+			{
+				const value_t& first = a ? *static_cast< const value_t* >( a ) : m_defaultValue;
+				const value_t& second = b ? *static_cast< const value_t* >( b ) : m_defaultValue;
+				return first == second;
+			}
+			return false;
+		}
+		
+		virtual uint64_t value_layout() const override
+		{
+			const auto layout = []( auto number ) -> uint64_t
+			{
+				using number_t = decltype( number );
+				return sizeof( number_t ) << 2 | std::is_floating_point< number_t >::value << 1 | std::is_signed< number_t >::value;
+			};
+			
+			if constexpr( std::is_arithmetic< value_t >::value )
+			{
+				return layout( value_t{} );
+			}
+			else if constexpr( detail::is_number_list< value_t >::value )
+			{
+				return layout( typename value_t::value_type{} ) | 1u << 16;
+			}
+			return 0;
+		}
+
+		friend class schema;
+		friend class parser;
+		friend class batch_result;
+		friend class parse_result;
+	};
+	
+	///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	
+	namespace detail
+	{
+		// A converted value kept outside its argument, in a parse_result or batch_result.
+		//
+		struct stored_value
+		{
+			const argument_abstract* argument;
+			void* slot;
+		};
+		
+		// A command line sets few arguments, so a scan of its own values is quick.
+		//
+		inline const void* find_stored_value( const stored_value* begin,
+											  const stored_value* end,
+											  const argument_abstract& arg )
+		{
+			const auto found = std::find_if( begin, end, [&]( const stored_value& v ) { return v.argument == &arg; } );
+			return found != end ? found->slot : nullptr;
+		}
+	}
+	
+	///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	
+	// The results of one schema::parse(): which arguments were set, their converted values, and the unlabeled
+	// arguments. Use its accessors with the argument handles that add() returned. Unlabeled arguments view argv,
+	// which must outlive the result; so must the schema.
+	//
+	class parse_result
+	{
+	public:
+		
+		parse_result( parse_result&& other ) noexcept
+		:	m_resource( other.m_resource )
+		,	m_values( std::move( other.m_values ))
+		,	m_unlabeledArguments( std::move( other.m_unlabeledArguments ))
+		,	m_helpRequested( other.m_helpRequested )
+		{
+			other.m_values.clear();
+		}
+		
+		parse_result& operator=( const parse_result& ) = delete;
+		
+		~parse_result()
+		{
+			for( const auto& v : m_values )
+			{
+				if( !v.argument->value_is_trivial() )
+				{
+					v.argument->destroy_value( v.slot );
+				}
+				m_resource->deallocate( v.slot, v.argument->value_size(), v.argument->value_alignment() );
+			}
+		}
+		
+		bool assigned( const argument_abstract& arg ) const
+		{
+			return find( arg ) != nullptr;
+		}
+		
+		template< typename ValueT >
+		const ValueT& value( const argument< ValueT >& arg ) const
+		{
+			const void* slot = find( arg );
+			return slot ? *static_cast< const ValueT* >( slot ) : arg.m_defaultValue;
+		}
+		
+		span< const std::string_view > unlabeled_arguments() const
+		{
+			return { m_unlabeledArguments.data(), m_unlabeledArguments.size() };
+		}
+		
+		// True if --help or -h was given, whether or not the schema has a help argument.
+		//
+		bool help_requested() const
+		{
+			return m_helpRequested;
+		}
+		
+	private:
+		
+		std::pmr::memory_resource* m_resource;
+		std::pmr::vector< detail::stored_value > m_values;
+		std::pmr::vector< std::string_view > m_unlabeledArguments;
+		bool m_helpRequested = false;
+		
+		explicit parse_result( std::pmr::memory_resource* resource )
+		:	m_resource( resource )
+		,	m_values( resource )
+		,	m_unlabeledArguments( resource )
+		{}
+		
+		const void* find( const argument_abstract& arg ) const
+		{
+			return detail::find_stored_value( m_values.data(), m_values.data() + m_values.size(), arg );
+		}
+		
+		friend class schema;
+		friend class live_options;
+	};
+	
+	///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	
+	// The results of schema::parse_batch(): one entry per command line, in order.
+	//
+	// Each entry has a compact record of the arguments that were set and their converted values, a span of its
+	// unlabeled arguments, and the exception its parse threw, if any. Records, values and unlabeled arguments are
+	// each stored contiguously for the whole batch. Arguments themselves are not modified, so use an entry's
+	// accessors with the argument handles that add() returned. String data is viewed, not copied: the command
+	// lines' argv must outlive the result, and so must the parser.
+	//
+	class batch_result
+	{
+		struct record;
+		
+	public:
+		
+		class entry
+		{
+		public:
+			
+			bool assigned( const argument_abstract& arg ) const
+			{
+				return find( arg ) != nullptr;
+			}
+			
+			template< typename ValueT >
+			const ValueT& value( const argument< ValueT >& arg ) const
+			{
+				const void* slot = find( arg );
+				return slot ? *static_cast< const ValueT* >( slot ) : arg.m_defaultValue;
+			}
+			
+			span< const std::string_view > unlabeled_arguments() const
+			{
+				return { m_result.m_unlabeledArguments.data() + m_record.unlabeledBegin, m_record.unlabeledCount };
+			}
+			
+			// Null if the command line parsed successfully.
+			//
+			const std::exception_ptr& error() const
+			{
+				return m_record.error;
+			}
+			
+			bool help_requested() const
+			{
+				return m_record.helpRequested;
+			}
+			
+		private:
+			
+			const batch_result& m_result;
+			const batch_result::record& m_record;
+			
+			entry( const batch_result& result, const batch_result::record& record )
+			:	m_result( result )
+			,	m_record( record )
+			{}
+			
+			const void* find( const argument_abstract& arg ) const
+			{
+				const detail::stored_value* const begin = m_result.m_values.data() + m_record.valuesBegin;
+				return detail::find_stored_value( begin, begin + m_record.valuesCount, arg );
+			}
+			
+			friend class batch_result;
+		};
+		
+		batch_result( batch_result&& other ) noexcept
+		:	m_records( std::move( other.m_records ))
+		,	m_values( std::move( other.m_values ))
+		,	m_unlabeledArguments( std::move( other.m_unlabeledArguments ))
+		,	m_valueStorage( std::move( other.m_valueStorage ))
+		{
+			other.m_values.clear();
+		}
+		
+		batch_result& operator=( const batch_result& ) = delete;
+		
+		~batch_result()
+		{
+			for( const auto& v : m_values )
+			{
+				if( !v.argument->value_is_trivial() )
+				{
+					v.argument->destroy_value( v.slot );
+				}
+			}
+		}
+		
+		size_t size() const
+		{
+			return m_records.size();
+		}
+		
+		entry operator[]( size_t index ) const
+		{
+			assert( index < m_records.size() );
+			return entry{ *this, m_records[ index ] };
+		}
+		
+	private:
+		
+		struct record
+		{
+			std::exception_ptr error;
+			size_t valuesBegin = 0;
+			size_t valuesCount = 0;
+			size_t unlabeledBegin = 0;
+			size_t unlabeledCount = 0;
+			bool helpRequested = false;
+		};
+		
+		std::pmr::vector< record > m_records;
+		std::pmr::vector< detail::stored_value > m_values;
+		std::pmr::vector< std::string_view > m_unlabeledArguments;
+		
+		// Where the value slots live: one arena per worker thread, since the schema's memory resource may not be
+		// safe to share between threads.
+		//
+		std::vector< std::unique_ptr< std::pmr::monotonic_buffer_resource >> m_valueStorage;
+		
+		batch_result( std::pmr::memory_resource* resource, size_t size )
+		:	m_records( size, resource )
+		,	m_values( resource )
+		,	m_unlabeledArguments( resource )
+		{}
+		
+		friend class schema;
+	};
+	
+	///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		
+	// The arguments a program accepts and the indices for finding them. Once the arguments are added, a schema
+	// is never modified by parsing: parse() and parse_batch() return their results rather than storing them, so
+	// any number of threads may parse against one schema at once without locking.
+	//
+	class schema
+	{
+	public:
+		
+		// Exception classes.
+		//
+		ARRRGH_EXCEPTION( InvalidParameters )
+		ARRRGH_EXCEPTION( UnknownArgument )
+		ARRRGH_EXCEPTION( FoundDoubleHyphensLeadingNowhere )
+		ARRRGH_EXCEPTION( InvalidArgumentCharacter )
+		ARRRGH_EXCEPTION( MissingRequiredArguments )
+		
+		// The schema's arguments and indices are allocated from resource, which must outlive the schema.
+		//
+		explicit schema( std::string_view programName,
+						 std::string_view programDescription,
+						 std::pmr::memory_resource* resource = std::pmr::get_default_resource() )
+		:	m_resource( resource )
+		,	m_arguments( resource )
+		,	m_program( programName, resource )
+		,	m_description( programDescription, resource )
+		,	m_longFormIndex( resource )
+		,	m_requiredArguments( resource )
+		{}
+		
+		// Neither copyable nor movable, and so neither is parser: a moved-from schema would still index the
+		// arguments it gave away, and a parser counting allocations has containers that allocate through the
+		// parser itself. To move one, hold it by std::unique_ptr.
+		//
+		schema( const schema& ) = delete;
+		schema& operator=( const schema& ) = delete;
+		
+		~schema()
+		{
+			for( argument_abstract* arg : m_arguments )
+			{
+				arg->destroy( m_resource );
+			}
+		}
+
+		template< typename ValueT >
+		argument< ValueT >& add( std::string_view longForm,
+								 std::string_view explanation,
+								 char letter = '\0',
+								 Requirement required = Optional,
+								 const ValueT& defaultValue = ValueT{} )
+		{
+			// Verify that no other argument has this longForm or letter.
+			//
+			assert( !has_long_form_argument( longForm ));
+			assert( !has_letter_argument( letter ));
+			
+			std::pmr::polymorphic_allocator< argument< ValueT >> allocator{ m_resource };
+			argument< ValueT >* arg = allocator.allocate( 1 );
+			
+			ARRRGH_TRY
+			{
+				new( arg ) argument< ValueT >{ longForm, explanation, letter, required, defaultValue, m_resource };
+			}
+			ARRRGH_CATCH_ALL
+			{
+				allocator.deallocate( arg, 1 );
+				ARRRGH_RETHROW;
+			}
+			
+			ARRRGH_TRY
+			{
+				m_arguments.push_back( arg );
+			}
+			ARRRGH_CATCH_ALL
+			{
+				static_cast< argument_abstract* >( arg )->destroy( m_resource );
+				ARRRGH_RETHROW;
+			}
+			arg->m_index = static_cast< uint32_t >( m_arguments.size() - 1 );
+			
+			// Index the new argument so that lookups during parsing don't have to scan m_arguments.
+			//
+			if( !longForm.empty() )
+			{
+				m_longFormIndex.emplace( arg->m_longForm, arg );
+			}
+			
+			if( letter != '\0' )
+			{
+				m_letterIndex[ static_cast< unsigned char >( letter ) ] = arg;
+			}
+			
+			if( required == Required )
+			{
+				m_requiredArguments.push_back( arg );
+			}
+			
+			return *arg;
+		}
+		
+		bool has_long_form_argument( std::string_view longForm ) const
+		{
+			return m_longFormIndex.find( longForm ) != m_longFormIndex.end();
+		}
+		
+		bool has_letter_argument( char letter ) const
+		{
+			return m_letterIndex[ static_cast< unsigned char >( letter ) ] != nullptr;
+		}
+		
+		// Parses one command line into a parse_result, whose values are allocated from resource. Throws as
+		// parser::parse() does. --help and -h are accepted even if no help argument was added; check
+		// help_requested() on the result.
+		//
+		parse_result parse( const int argc,
+							const char* const argv[],
+							std::pmr::memory_resource* resource = std::pmr::get_default_resource() ) const
+		{
+			parse_result result{ resource };
+			
+			parse_record( command_line{ argc, argv },
+						  required_count(),
+						  *resource,
+						  result.m_values,
+						  result.m_unlabeledArguments,
+						  result.m_helpRequested );
+			
+			return result;
+		}
+		
+		// Parses many command lines, spread across threadCount threads (or one per hardware thread if 0).
+		// Each command line's results are in the returned batch_result, whose entries are in the same order as
+		// commandLines. A command line that fails to parse records its exception in its entry rather than throwing.
+		//
+		// Like parse( ..., arrrgh::Borrow ), this keeps views into each argv.
+		//
+		batch_result parse_batch( span< const command_line > commandLines, unsigned int threadCount = 0 ) const
+		{
+			batch_result result{ m_resource, commandLines.size() };
+			
+			const size_t requiredCount = required_count();
+			
+			// Workers claim chunks of command lines from a shared counter until none are left, so that a slow chunk
+			// on one thread doesn't hold up the others. Each keeps its values and unlabeled arguments to itself
+			// until the end.
+			//
+			constexpr size_t chunkSize = 16;
+			
+			if( threadCount == 0 )
+			{
+				threadCount = std::max( std::thread::hardware_concurrency(), 1u );
+			}
+			threadCount = static_cast< unsigned int >( std::min< size_t >( threadCount,
+																		   ( commandLines.size() + chunkSize - 1 ) / chunkSize ));
+			threadCount = std::max( threadCount, 1u );
+			
+			struct worker
+			{
+				std::pmr::vector< detail::stored_value > values;
+				std::pmr::vector< std::string_view > unlabeledArguments;
+			};
+			
+			std::vector< worker > workers( threadCount );
+			std::vector< unsigned int > recordWorkers( commandLines.size() );
+			std::atomic< size_t > nextChunk{ 0 };
+			
+			for( unsigned int i = 0; i < threadCount; ++i )
+			{
+				result.m_valueStorage.emplace_back( new std::pmr::monotonic_buffer_resource{ std::pmr::new_delete_resource() } );
+			}
+			
+			auto work = [&]( unsigned int workerIndex )
+			{
+				worker& self = workers[ workerIndex ];
+				
+				for( ;; )
+				{
+					const size_t begin = nextChunk.fetch_add( chunkSize );
+					if( begin >= commandLines.size() )
+					{
+						break;
+					}
+					
+					const size_t end = std::min( begin + chunkSize, commandLines.size() );
+					for( size_t i = begin; i < end; ++i )
+					{
+						auto& record = result.m_records[ i ];
+						record.valuesBegin = self.values.size();
+						record.unlabeledBegin = self.unlabeledArguments.size();
+						recordWorkers[ i ] = workerIndex;
+						
+						ARRRGH_TRY
+						{
+							parse_record( commandLines[ i ],
+										  requiredCount,
+										  *result.m_valueStorage[ workerIndex ],
+										  self.values,
+										  self.unlabeledArguments,
+										  record.helpRequested );
+						}
+						ARRRGH_CATCH_ALL
+						{
+							record.error = std::current_exception();
+						}
+						
+						record.valuesCount = self.values.size() - record.valuesBegin;
+						record.unlabeledCount = self.unlabeledArguments.size() - record.unlabeledBegin;
+					}
+				}
+			};
+			
+			std::vector< std::thread > threads;
+			for( unsigned int i = 1; i < threadCount; ++i )
+			{
+				threads.emplace_back( work, i );
+			}
+			work( 0 );
+			for( auto& thread : threads )
+			{
+				thread.join();
+			}
+			
+			// Gather the workers' values and unlabeled arguments into one array each.
+			//
+			std::vector< std::pair< size_t, size_t >> workerBegins( threadCount );
+			size_t totalValues = 0;
+			size_t totalUnlabeled = 0;
+			for( unsigned int i = 0; i < threadCount; ++i )
+			{
+				workerBegins[ i ] = { totalValues, totalUnlabeled };
+				totalValues += workers[ i ].values.size();
+				totalUnlabeled += workers[ i ].unlabeledArguments.size();
+			}
+			
+			result.m_values.reserve( totalValues );
+			result.m_unlabeledArguments.reserve( totalUnlabeled );
+			for( const auto& worker : workers )
+			{
+				result.m_values.insert( result.m_values.end(), worker.values.begin(), worker.values.end() );
+				result.m_unlabeledArguments.insert( result.m_unlabeledArguments.end(),
+												   worker.unlabeledArguments.begin(),
+												   worker.unlabeledArguments.end() );
+			}
+			
+			for( size_t i = 0; i < commandLines.size(); ++i )
+			{
+				result.m_records[ i ].valuesBegin += workerBegins[ recordWorkers[ i ]].first;
+				result.m_records[ i ].unlabeledBegin += workerBegins[ recordWorkers[ i ]].second;
+			}
+			
+			return result;
+		}
+		
+		void show_usage( std::ostream& out = std::cout ) const
+		{
+			out << m_program << ": " << m_description << std::endl;
+			out << "usage: " << m_program << std::endl;
+			
+			for( const auto& arg : m_arguments )
+			{
+				assert( arg );
+				arg->print( out );
+				out << std::endl;
+			}
+			out << std::endl;
+		}
+		
+		template< typename Function >
+		void each_argument( Function&& fn ) const
+		{
+			std::for_each( m_arguments.begin(), m_arguments.end(),
+						  [&]( const argument_abstract* arg )
+						  {
+							  assert( arg );
+							  fn( *arg );
+						  } );
+		}
+		
+		// A hash of the arguments' names, letters and value types, in order, which changes whenever the schema
+		// does in a way that matters to saved values.
+		//
+		uint64_t fingerprint() const
+		{
+			uint64_t result = detail::hash( m_program );
+			for( const argument_abstract* arg : m_arguments )
+			{
+				const uint64_t fields[] = { detail::hash( arg->m_longForm ),
+											static_cast< unsigned char >( arg->m_letter ),
+											detail::hash( arg->value_type_name() ),
+											arg->value_size(),
+											arg->value_layout() };
+				result = detail::hash_bytes( reinterpret_cast< const char* >( fields ), sizeof( fields )) ^ ( result * 31 );
+			}
+			return result;
+		}
+		
+	protected:
+		
+		std::pmr::memory_resource* m_resource;
+		std::pmr::vector< argument_abstract* > m_arguments;
+		
+		std::string_view program_name() const
+		{
+			return m_program;
+		}
+		
+		// Returns nullptr if no argument has this long form or letter.
+		//
+		argument_abstract* find_argument( std::string_view longForm ) const
+		{
+			auto iterFound = m_longFormIndex.find( longForm );
+			assert( iterFound == m_longFormIndex.end() || iterFound->second->has_long_form( longForm ));
+			
+			return iterFound != m_longFormIndex.end() ? iterFound->second : nullptr;
+		}
+		
+		argument_abstract* find_argument( char letter ) const
+		{
+			argument_abstract* const found = m_letterIndex[ static_cast< unsigned char >( letter ) ];
+			assert( !found || found->has_short_form( letter ));
+			
+			return found;
+		}
+		
+		argument_abstract& find_matching_argument( std::string_view longForm ) const
+		{
+			argument_abstract* const found = find_argument( longForm );
+			
+			if( !found )
+			{
+				detail::suggestion_list suggestions;
+				suggest_long_forms( longForm, suggestions );
+				
+				std::ostringstream message;
+				message << "Unrecognized argument \"--" << longForm << "\".";
+				suggestions.print( message, "--" );
+				ARRRGH_THROW( UnknownArgument{ message.str() } );
+			}
+			return *found;
+		}
+		
+		// Finds the long forms nearest to an unknown one, for an error message. Only those about as long as it
+		// are measured, and each only as far as it could still be near.
+		//
+		void suggest_long_forms( std::string_view longForm, detail::suggestion_list& suggestions ) const
+		{
+			suggestions.clear();
+			if( longForm.empty() || longForm.size() > detail::edit_distance_pattern::maxLength )
+			{
+				return;
+			}
+			
+			const detail::edit_distance_pattern pattern( longForm );
+			const uint32_t limit = pattern.suggestion_limit();
+			
+			for( const argument_abstract* arg : m_arguments )
+			{
+				const std::string_view name = arg->m_longForm;
+				const size_t lengthDifference = name.size() > longForm.size() ? name.size() - longForm.size() : longForm.size() - name.size();
+				
+				if( !name.empty() && lengthDifference <= limit )
+				{
+					const uint32_t distance = pattern.distance( name, limit );
+					if( distance <= limit )
+					{
+						suggestions.offer( name, distance );
+					}
+				}
+			}
+		}
+		
+#if ARRRGH_ENABLE_STATS
+		// How many index entries finding longForm examines: those in its hash bucket.
+		//
+		size_t lookup_probes( std::string_view longForm ) const
+		{
+			return m_longFormIndex.bucket_size( m_longFormIndex.bucket( longForm ));
+		}
+#endif
+		
+		argument_abstract& find_matching_argument( char letter ) const
+		{
+			argument_abstract* const found = find_argument( letter );
+			
+			if( !found )
+			{
+				ARRRGH_THROW( UnknownArgument{ arrrgh_collect_string( "Unrecognized argument \"-" << letter << "\"." ) } );
+			}
+			return *found;
+		}
+		
+		// If there's no help argument, adds one. The help argument is found once and remembered.
+		//
+		const argument< bool >& add_help_argument()
+		{
+			if( !m_helpArgument )
+			{
+				if( !has_long_form_argument( "help" ))
+				{
+					add< bool >( "help",
+								 "Prints this help message.",
+								 !has_letter_argument( 'h' ) ? 'h' : '\0' );
+				}
+				
+				auto iterHelpArg = m_longFormIndex.find( "help" );
+				assert( m_longFormIndex.end() != iterHelpArg );
+				
+				m_helpArgument = static_cast< const argument< bool >* >( iterHelpArg->second );
+			}
+			
+			return *m_helpArgument;
+		}
+		
+		size_t required_count() const
+		{
+			return m_requiredArguments.size();
+		}
+		
+		// Names each required argument for which isAssigned( argument ) is false. Only called once a parse is known
+		// to have missed some, so it's fine that it looks at them all.
+		//
+		template< typename Predicate >
+		std::string missing_required_arguments_message( Predicate&& isAssigned ) const
+		{
+			std::ostringstream message;
+			message << "Missing required arguments:";
+			
+			const char* separator = " ";
+			for( const argument_abstract* arg : m_requiredArguments )
+			{
+				if( !isAssigned( *arg ))
+				{
+					message << separator << ( arg->m_longForm.empty() ? "-" : "--" ) << arg->best_name();
+					separator = ", ";
+				}
+			}
+			message << ".";
+			
+			return message.str();
+		}
+		
+		template< typename Predicate >
+		[[noreturn]] void throw_missing_required_arguments( Predicate&& isAssigned ) const
+		{
+			ARRRGH_THROW( MissingRequiredArguments{ missing_required_arguments_message( isAssigned ) } );
+		}
+		
+	private:
+		
+		std::pmr::string m_program;
+		std::pmr::string m_description;
+		
+		// Lookup indices into m_arguments, maintained by add(). The long-form keys view each argument's own m_longForm.
+		//
+		std::pmr::unordered_map< std::string_view, argument_abstract* > m_longFormIndex;
+		std::array< argument_abstract*, 256 > m_letterIndex{};
+		
+		// The required arguments, so that checking for them needn't look at every argument.
+		//
+		std::pmr::vector< const argument_abstract* > m_requiredArguments;
+		
+		const argument< bool >* m_helpArgument = nullptr;
+		
+		// Parses one command line, appending its values and unlabeled arguments to the given lists and allocating
+		// value slots from valueStorage. Touches nothing shared but the (read-only) arguments and indices.
+		//
+		void parse_record( const command_line& commandLine,
+						   size_t requiredCount,
+						   std::pmr::memory_resource& valueStorage,
+						   std::pmr::vector< detail::stored_value >& values,
+						   std::pmr::vector< std::string_view >& unlabeledArguments,
+						   bool& helpRequested ) const
+		{
+			if( commandLine.argc == 0 || !commandLine.argv )
+			{
+				ARRRGH_THROW( InvalidParameters{ "Received no arguments." } );
+			}
+			
+			struct handler
+			{
+				const schema& self;
+				std::pmr::memory_resource& valueStorage;
+				std::pmr::vector< detail::stored_value >& values;
+				std::pmr::vector< std::string_view >& unlabeledArguments;
+				bool& helpRequested;
+				const size_t valuesBegin;
+				size_t requiredAssigned;
+				
+				bool store( const argument_abstract& argument, std::string_view value )
+				{
+					if( value.empty() && argument.required_value() )
+					{
+						argument_abstract::throw_missing_value();
+					}
+					
+					if( argument.has_long_form( "help" ))
+					{
+						helpRequested = true;
+					}
+					
+					// Reuse the slot if this argument was already given.
+					//
+					const auto existing = std::find_if( values.begin() + valuesBegin, values.end(),
+													   [&]( const detail::stored_value& v ) { return v.argument == &argument; } );
+					
+					if( existing != values.end() )
+					{
+						if( !argument.store_value( existing->slot, value, true /* constructed */ ))
+						{
+							argument.throw_conversion_error_for( value );
+						}
+						return true;
+					}
+					
+					void* slot = valueStorage.allocate( argument.value_size(), argument.value_alignment() );
+					if( !argument.store_value( slot, value, false ))
+					{
+						argument.destroy_value( slot );
+						valueStorage.deallocate( slot, argument.value_size(), argument.value_alignment() );
+						argument.throw_conversion_error_for( value );
+					}
+					
+					ARRRGH_TRY
+					{
+						values.push_back( { &argument, slot } );
+					}
+					ARRRGH_CATCH_ALL
+					{
+						argument.destroy_value( slot );
+						valueStorage.deallocate( slot, argument.value_size(), argument.value_alignment() );
+						ARRRGH_RETHROW;
+					}
+					
+					if( argument.required() )
+					{
+						++requiredAssigned;
+					}
+					return true;
+				}
+				
+				bool long_form( std::string_view key, std::string_view value )
+				{
+					if( key == "help" && !self.has_long_form_argument( key ))
+					{
+						helpRequested = true;
+						return true;
+					}
+					return store( self.find_matching_argument( key ), value );
+				}
+				
+				bool letter( std::string_view letter, std::string_view value )
+				{
+					const char c = letter[ 0 ];
+					if( c == 'h' && !self.has_letter_argument( c ) && !self.has_long_form_argument( "help" ))
+					{
+						helpRequested = true;
+						return true;
+					}
+					return store( self.find_matching_argument( c ), value );
+				}
+				
+				bool invalid_letter( std::string_view letter )
+				{
+					ARRRGH_THROW( InvalidArgumentCharacter{
+						arrrgh_collect_string( "Invalid argument with character '" << letter << "'." ) } );
+				}
+				
+				bool unlabeled( std::string_view arg )
+				{
+					unlabeledArguments.push_back( arg );
+					return true;
+				}
+			};
+			
+			handler h{ *this, valueStorage, values, unlabeledArguments, helpRequested, values.size(), 0 };
+			detail::scan_arguments( commandLine.argc, commandLine.argv, h );
+			
+			// Did each of the *required* arguments get assigned?
+			//
+			if( h.requiredAssigned != requiredCount )
+			{
+				const detail::stored_value* const begin = values.data() + h.valuesBegin;
+				const detail::stored_value* const end = values.data() + values.size();
+				
+				throw_missing_required_arguments( [&]( const argument_abstract& arg )
+												  {
+													  return detail::find_stored_value( begin, end, arg ) != nullptr;
+												  } );
+			}
+		}
+	};
+	
+	///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	
+	// Options that a running program can be given again, from a control channel say, while other threads go on
+	// reading them.
+	//
+	// Each command line is parsed into an immutable snapshot, which reconfigure() then publishes with one atomic
+	// store. A thread reads through its own reader, whose read() returns the current snapshot and keeps it alive
+	// until the returned guard is destroyed. Reading is wait-free: it doesn't lock, retry or wait on writers, and
+	// touches only its own reader's counter and the shared pointer.
+	//
+	// Snapshots replaced by reconfigure() are freed once no reader can still be using them. Each read() announces
+	// the publication epoch it began in. A replaced snapshot is freed only when every reader is idle or began after
+	// the snapshot was replaced. The check runs on each reconfigure() and when the live_options is destroyed, so
+	// writers never wait for readers either.
+	//
+	class live_options
+	{
+		struct reader_slot;
+		
+	public:
+		
+		// One parse of a command line, which the snapshot keeps a copy of. Use its accessors with the argument
+		// handles that add() returned.
+		//
+		class snapshot
+		{
+		public:
+			
+			bool assigned( const argument_abstract& arg ) const
+			{
+				return m_result.assigned( arg );
+			}
+			
+			template< typename ValueT >
+			const ValueT& value( const argument< ValueT >& arg ) const
+			{
+				return m_result.value( arg );
+			}
+			
+			span< const std::string_view > unlabeled_arguments() const
+			{
+				return m_result.unlabeled_arguments();
+			}
+			
+			// Counts up from 1 with each snapshot published.
+			//
+			uint64_t generation() const
+			{
+				return m_generation;
+			}
+			
+		private:
+			
+			// The copied argv, which must be made before m_result views it.
+			//
+			struct command_line_copy
+			{
+				std::string text;
+				std::vector< const char* > argv;
+				
+				command_line_copy( const int argc, const char* const argv[] )
+				{
+					std::vector< size_t > offsets;
+					for( int i = 0; i < argc; ++i )
+					{
+						offsets.push_back( text.size() );
+						text.append( argv[ i ] ).push_back( '\0' );
+					}
+					for( const size_t offset : offsets )
+					{
+						this->argv.push_back( text.data() + offset );
+					}
+				}
+			};
+			
+			command_line_copy m_commandLine;
+			parse_result m_result;
+			uint64_t m_generation;
+			
+			snapshot( const schema& options, const int argc, const char* const argv[], uint64_t generation )
+			:	m_commandLine( argc, argv )
+			,	m_result( options.parse( argc, m_commandLine.argv.data(), std::pmr::new_delete_resource() ))
+			,	m_generation( generation )
+			{}
+			
+			friend class live_options;
+		};
+		
+		// Holds a snapshot for reading and ends the read when destroyed.
+		//
+		class guard
+		{
+		public:
+			
+			guard( const guard& ) = delete;
+			guard& operator=( const guard& ) = delete;
+			
+			~guard()
+			{
+				m_slot.epoch.store( 0 );
+			}
+			
+			const snapshot& operator*() const
+			{
+				return m_snapshot;
+			}
+			
+			const snapshot* operator->() const
+			{
+				return &m_snapshot;
+			}
+			
+		private:
+			
+			reader_slot& m_slot;
+			const snapshot& m_snapshot;
+			
+			guard( reader_slot& slot, const snapshot& current )
+			:	m_slot( slot )
+			,	m_snapshot( current )
+			{}
+			
+			friend class live_options;
+		};
+		
+		// A reading thread's handle. Each thread that reads needs its own, and must not hold two guards from it at
+		// once. It must not outlive the live_options.
+		//
+		class reader
+		{
+		public:
+			
+			reader( const reader& ) = delete;
+			reader& operator=( const reader& ) = delete;
+			
+			reader( reader&& other ) noexcept
+			:	m_options( other.m_options )
+			,	m_slot( other.m_slot )
+			{
+				other.m_slot = nullptr;
+			}
+			
+			~reader()
+			{
+				if( m_slot )
+				{
+					m_options.release_slot( *m_slot );
+				}
+			}
+			
+			guard read() const
+			{
+				assert( m_slot && m_slot->epoch.load() == 0 );
+				
+				m_slot->epoch.store( m_options.m_epoch.load() );
+				return guard{ *m_slot, *m_options.m_current.load() };
+			}
+			
+		private:
+			
+			live_options& m_options;
+			reader_slot* m_slot;
+			
+			reader( live_options& options, reader_slot& slot )
+			:	m_options( options )
+			,	m_slot( &slot )
+			{}
+			
+			friend class live_options;
+		};
+		
+		// Parses the first command line, throwing as schema::parse() does. options must outlive the live_options.
+		//
+		live_options( const schema& options, const int argc, const char* const argv[] )
+		:	m_schema( options )
+		,	m_current( new snapshot( options, argc, argv, 1 ))
+		{}
+		
+		live_options( const live_options& ) = delete;
+		live_options& operator=( const live_options& ) = delete;
+		
+		// No reader may be reading.
+		//
+		~live_options()
+		{
+			reclaim();
+			assert( m_retired.empty() );
+			delete m_current.load();
+		}
+		
+		reader make_reader()
+		{
+			std::lock_guard< std::mutex > lock( m_mutex );
+			
+			for( reader_slot& slot : m_slots )
+			{
+				if( !slot.inUse )
+				{
+					slot.inUse = true;
+					return reader{ *this, slot };
+				}
+			}
+			
+			m_slots.emplace_back().inUse = true;
+			return reader{ *this, m_slots.back() };
+		}
+		
+		// Parses argv into a new snapshot and publishes it, returning the arguments whose values differ from the
+		// last snapshot's. If argv doesn't parse, throws as schema::parse() does and the last snapshot stays.
+		// argv needn't outlive the call.
+		//
+		std::vector< const argument_abstract* > reconfigure( const int argc, const char* const argv[] )
+		{
+			std::lock_guard< std::mutex > lock( m_mutex );
+			
+			const snapshot* const previous = m_current.load();
+			const snapshot* const next = new snapshot( m_schema, argc, argv, previous->m_generation + 1 );
+			
+			std::vector< const argument_abstract* > changed;
+			m_schema.each_argument( [&]( const argument_abstract& arg )
+									{
+										if( !arg.same_value( previous->m_result.find( arg ), next->m_result.find( arg )))
+										{
+											changed.push_back( &arg );
+										}
+									} );
+			
+			// Publish, then note the epoch in which previous was replaced and start a new one. A read that starts
+			// in a later epoch can only see next (or newer).
+			//
+			m_current.store( next );
+			m_retired.push_back( { previous, m_epoch.load() } );
+			m_epoch.fetch_add( 1 );
+			
+			reclaim();
+			return changed;
+		}
+		
+		// How many replaced snapshots are still waiting for readers to finish with them.
+		//
+		size_t unreclaimed() const
+		{
+			std::lock_guard< std::mutex > lock( m_mutex );
+			return m_retired.size();
+		}
+		
+	private:
+		
+		struct reader_slot
+		{
+			std::atomic< uint64_t > epoch{ 0 };		// The epoch the current read began in, or 0 between reads.
+			bool inUse = false;
+		};
+		
+		struct retired_snapshot
+		{
+			const snapshot* replaced;
+			uint64_t epoch;
+		};
+		
+		const schema& m_schema;
+		std::atomic< const snapshot* > m_current;
+		std::atomic< uint64_t > m_epoch{ 1 };
+		
+		mutable std::mutex m_mutex;					// Serializes writers, and guards the rest.
+		std::deque< reader_slot > m_slots;			// A deque, so that readers' pointers stay put.
+		std::vector< retired_snapshot > m_retired;
+		
+		// Frees each replaced snapshot that no read can still be using: one replaced in an epoch before any
+		// reading reader's.
+		//
+		void reclaim()
+		{
+			uint64_t oldestRead = UINT64_MAX;
+			for( const reader_slot& slot : m_slots )
+			{
+				const uint64_t epoch = slot.epoch.load();
+				if( epoch != 0 )
+				{
+					oldestRead = std::min( oldestRead, epoch );
+				}
+			}
+			
+			const auto reclaimable = [&]( const retired_snapshot& retired ) { return retired.epoch < oldestRead; };
+			
+			for( const retired_snapshot& retired : m_retired )
+			{
+				if( reclaimable( retired ))
+				{
+					delete retired.replaced;
+				}
+			}
+			m_retired.erase( std::remove_if( m_retired.begin(), m_retired.end(), reclaimable ), m_retired.end() );
+		}
+		
+		void release_slot( reader_slot& slot )
+		{
+			std::lock_guard< std::mutex > lock( m_mutex );
+			
+			assert( slot.epoch.load() == 0 );
+			slot.inUse = false;
+		}
+	};
+
+	///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	
+	// A schema that also keeps the results of its last parse() in its arguments, for programs that parse one
+	// command line and read the values straight from the argument handles.
+	//
+	class parser : public schema
+	{
+	public:
+		
+		ARRRGH_EXCEPTION( UnreadableResponseFile )
+		ARRRGH_EXCEPTION( UnknownSubcommand )
+		ARRRGH_EXCEPTION( UnreadableConfigFile )
+		ARRRGH_EXCEPTION( MalformedConfigFile )
+		ARRRGH_EXCEPTION( AmbiguousArgument )
+		ARRRGH_EXCEPTION( UnreadableSavedValues )
+		ARRRGH_EXCEPTION( MismatchedSavedValues )
+		
+		// All of the parser's memory--arguments, indices, copied argument text and unlabeled arguments--comes from
+		// resource, which must outlive the parser. After a warm-up parse, parse() and clear_values() cycles reuse
+		// that memory rather than allocating more.
+		//
+		explicit parser( std::string_view programName,
+						 std::string_view programDescription,
+						 std::pmr::memory_resource* resource = std::pmr::get_default_resource() )
+		:	schema( programName, programDescription, resource )
+#if ARRRGH_ENABLE_STATS
+		,	m_statsResource( resource, m_stats.allocations )
+#endif
+		,	m_unlabeledArguments( parse_resource() )
+		,	m_assignedArguments( parse_resource() )
+		,	m_argumentText( parse_resource() )
+		,	m_argumentPointers( parse_resource() )
+		,	m_responseFiles( parse_resource() )
+		,	m_subcommands( resource )
+		,	m_environmentPrefix( resource )
+		,	m_environmentNames( resource )
+		,	m_environmentIndex( resource )
+		,	m_environmentMatches( parse_resource() )
+		,	m_configPath( resource )
+		,	m_configEntries( parse_resource() )
+		,	m_longFormTrie( resource )
+		{}
+		
+		~parser()
+		{
+			for( auto& command : m_subcommands )
+			{
+				if( command.built )
+				{
+					destroy_subcommand( command.built );
+				}
+			}
+		}
+		
+		// Where parse() time has gone. All zeros unless ARRRGH_ENABLE_STATS is defined as 1.
+		//
+		const parse_stats& stats() const
+		{
+#if ARRRGH_ENABLE_STATS
+			return m_stats;
+#else
+			static const parse_stats none;
+			return none;
+#endif
+		}
+		
+		void reset_stats()
+		{
+#if ARRRGH_ENABLE_STATS
+			m_stats = parse_stats{};
+#endif
+		}
+		
+		// With this on, parse() replaces each "@path" argument (before any "--") with the entries of the response
+		// file at path: one argument per line, or per NUL-separated string, optionally quoted. "@path" entries
+		// within a response file are not expanded further. The file is memory-mapped and its entries are used
+		// in place, so even a huge list of arguments costs little more than the mapping. Values from a response
+		// file stay valid until clear_values(), regardless of Ownership.
+		//
+		void expand_response_files( bool expand = true )
+		{
+			m_expandResponseFiles = expand;
+		}
+		
+		// Hands each unlabeled argument to sink as soon as parse() comes across it, instead of collecting them
+		// for each_unlabeled_argument(), so that work on the first ones can start while the rest of argv (or a
+		// response file) is still being parsed. The parser keeps no storage for them. The views stay valid until
+		// clear_values() (or as long as argv, with arrrgh::Borrow), so sink may hand them to other threads.
+		// parse() may still throw after some arguments have gone to the sink.
+		//
+		// Pass an empty function to go back to collecting them.
+		//
+		void stream_unlabeled_arguments( std::function< void( std::string_view ) > sink )
+		{
+			m_unlabeledSink = std::move( sink );
+		}
+		
+		// Lets the environment variable named variable supply argument's value when the command line doesn't. The
+		// command line takes precedence over the environment, which takes precedence over the default. A variable
+		// that's set but empty is ignored.
+		//
+		void bind_environment( const argument_abstract& argument, std::string_view variable )
+		{
+			assert( !variable.empty() );
+			
+			const std::pmr::string& name = m_environmentNames.emplace_back( variable );
+			m_environmentIndex.insert_or_assign( name, environment_binding{ const_cast< argument_abstract* >( &argument ), true } );
+		}
+		
+		// Binds each argument with a long form, including those added later, to the variable named prefix followed
+		// by the long form in upper case, with '_' for '-': with prefix "MYTOOL_", --max-jobs reads MYTOOL_MAX_JOBS.
+		// bind_environment() takes precedence.
+		//
+		void bind_environment_prefix( std::string_view prefix )
+		{
+			m_environmentPrefix = prefix;
+			m_environmentPrefixSet = true;
+		}
+		
+		// With this on, parse() also takes an unambiguous prefix of a long form as that long form, as GNU
+		// getopt_long does: "--verb" for "--verbose", unless another long form starts with "verb" too, which is
+		// an error. An exact match always wins.
+		//
+		void allow_abbreviations( bool allow = true )
+		{
+			m_allowAbbreviations = allow;
+		}
+		
+		// Answers a shell completion query and returns true if argv asks for one: if argv[ 1 ] is
+		// "--arrrgh-complete", writes each long form (as "--name") and subcommand that could complete the word
+		// being completed to out, one per line. The word is argv[ 2 ], or argv[ 3 ] if there are more, as bash's
+		// "complete -C 'tool --arrrgh-complete' tool" passes the command's name first. Call it as soon as the
+		// arguments are added, and exit if it returns true, so that completion doesn't wait on the rest of the
+		// program's start-up.
+		//
+		bool complete( const int argc, const char* const argv[], std::ostream& out = std::cout )
+		{
+			if( argc < 2 || std::strcmp( argv[ 1 ], "--arrrgh-complete" ) != 0 )
+			{
+				return false;
+			}
+			
+			const std::string_view word = argc > 3 ? argv[ 3 ] : argc > 2 ? argv[ 2 ] : "";
+			
+			if( word.empty() || word[ 0 ] != '-' )
+			{
+				for( const auto& command : m_subcommands )
+				{
+					if( std::string_view( command.name ).substr( 0, word.size() ) == word )
+					{
+						out << command.name << '\n';
+					}
+				}
+			}
+			
+			if( word.empty() || word == "-" || word.substr( 0, 2 ) == "--" )
+			{
+				add_help_argument();
+				
+				const auto matches = long_form_trie().starting_with( word.substr( std::min< size_t >( word.size(), 2 )));
+				for( auto match = matches.first; match != matches.second; ++match )
+				{
+					out << "--" << match->first << '\n';
+				}
+			}
+			
+			out.flush();
+			return true;
+		}
+		
+		// Lets the config file at path supply the values of arguments that neither the command line nor the
+		// environment does. Each line is "key = value", where key is an argument's long form; blank lines and
+		// those starting with '#' or ';' are ignored, and a value may be quoted. A key given more than once is
+		// assigned more than once, as on the command line. The file is memory-mapped and its values are used in
+		// place, lasting until clear_values().
+		//
+		// With cache, parse() also keeps the file's converted values in path + ".cache", once they've all
+		// converted, and while the file's size, modification time and contents hash are unchanged (and the
+		// arguments are the same), reads that instead of the text: numbers and lists of numbers are copied
+		// straight into their arguments. A cache that can't be written or read is silently passed over.
+		//
+		void set_config_file( std::string_view path, bool cache = false )
+		{
+			m_configPath = path;
+			m_configCache = cache;
+		}
+		
+		// Reads variables from environment, "NAME=value" strings ending with nullptr, instead of the process's.
+		// It must outlive the parse and, with arrrgh::Borrow, the values.
+		//
+		void set_environment( const char* const* environment )
+		{
+			m_environment = environment;
+		}
+		
+		// Adds a git-style subcommand. When the first unlabeled argument is name, parse() makes a parser for the
+		// subcommand, passes it to registration to add its arguments, and has it parse the rest of the command line
+		// (with name as its argv[ 0 ]). Switches before name are the parent's. So only the subcommand that's used
+		// has its arguments registered, and only once: its parser is kept for later parses, sharing this one's
+		// memory resource. Read its values through the handles its add() calls returned. If registration throws,
+		// the exception propagates from parse() and try_parse() alike, no subcommand is active, and the next parse
+		// that names the subcommand registers it afresh.
+		//
+		void add_subcommand( std::string_view name,
+							 std::string_view description,
+							 std::function< void( parser& ) > registration )
+		{
+			assert( !name.empty() && name[ 0 ] != '-' );
+			assert( !m_activeSubcommand );		// Add them before parsing.
+			assert( std::none_of( m_subcommands.begin(), m_subcommands.end(),
+								  [&]( const subcommand& command ) { return command.name == name; } ));
+			
+			m_subcommands.push_back( subcommand{ std::pmr::string( name, m_resource ),
+												 std::pmr::string( description, m_resource ),
+												 std::move( registration ),
+												 nullptr } );
+		}
+		
+		// The parser of the subcommand that the last parse ran, or nullptr if there wasn't one.
+		//
+		const parser* subcommand_parser() const
+		{
+			return m_activeSubcommand ? m_activeSubcommand->built : nullptr;
+		}
+		
+		std::string_view subcommand_name() const
+		{
+			return m_activeSubcommand ? std::string_view{ m_activeSubcommand->name } : std::string_view{};
+		}
+		
+		// Shows the usage of the named subcommand, registering its arguments if that hasn't happened yet. Returns
+		// false if there's no such subcommand.
+		//
+		bool show_subcommand_usage( std::string_view name, std::ostream& out = std::cout )
+		{
+			subcommand* const command = find_subcommand( name );
+			if( !command )
+			{
+				return false;
+			}
+			build_subcommand( *command ).show_usage( out );
+			return true;
+		}
+		
+		// Lists the subcommands, if there are any, after the arguments.
+		//
+		void show_usage( std::ostream& out = std::cout ) const
+		{
+			schema::show_usage( out );
+			
+			if( !m_subcommands.empty() )
+			{
+				out << "commands:" << std::endl;
+				for( const auto& command : m_subcommands )
+				{
+					out << "    " << command.name << "\n\t\t" << command.description << std::endl;
+				}
+				out << std::endl;
+			}
+		}
+		
+		void parse( const int argc, const char* const argv[], Ownership ownership = Copy )
+		{
+			const parse_status status = try_parse( argc, argv, ownership );
+			
+			if( !status )
+			{
+				throw_parse_error( status );
+			}
+		}
+		
+		// Like parse(), but reports errors by returning them instead of throwing, and works without exceptions
+		// (-fno-exceptions). Failing allocates nothing: the details stay in the parser until the next parse or
+		// clear_values(), and error_message() renders them only if asked. Arguments before the one at fault are
+		// assigned as usual. An exception thrown by a subcommand's registration (see add_subcommand()) is the
+		// program's own, not a parse error, so it still propagates.
+		//
+		parse_status try_parse( const int argc, const char* const argv[], Ownership ownership = Copy )
+		{
+			ARRRGH_STATS( ++m_stats.parses );
+			ARRRGH_STATS_TIMER( m_stats.totalNanoseconds );
+			
+			clear_error();
+			
+			if( argc == 0 || !argv )
+			{
+				return parse_status{ parse_error::no_arguments };
+			}
+			
+			if( ownership == Copy )
+			{
+				argv = copy_arguments( argc, argv );
+			}
+
+			const argument< bool >& helpArg = add_help_argument();
+			
+			m_programExecutionPath = argv[ 0 ];
+			
+			// Determine which configured argument corresponds to each program argument, if any,
+			// and parse any value it might have.
+			//
+			struct handler
+			{
+				parser& self;
+				Ownership ownership;
+				
+				bool long_form( std::string_view key, std::string_view value )
+				{
+					argument_abstract* argument;
+					{
+						ARRRGH_STATS( self.m_stats.lookupProbes += self.lookup_probes( key ));
+						ARRRGH_STATS_TIMER( self.m_stats.lookupNanoseconds );
+						argument = self.find_argument( key );
+					}
+					
+					const std::string_view token{ key.data() - 2, key.size() + 2 };		// With its "--".
+					
+					if( !argument && self.m_allowAbbreviations )
+					{
+						const auto matches = self.long_form_trie().starting_with( key );
+						if( matches.second - matches.first > 1 )
+						{
+							return self.fail( parse_error::ambiguous_argument, token );
+						}
+						argument = matches.first != matches.second ? matches.first->second : nullptr;
+					}
+					
+					if( !argument )
+					{
+						self.suggest_from_trie( key );
+						return self.fail( parse_error::unknown_argument, token );
+					}
+					return self.process_argument( *argument, token, value, ownership );
+				}
+				
+				bool letter( std::string_view letter, std::string_view value )
+				{
+					argument_abstract* argument;
+					{
+						ARRRGH_STATS( ++self.m_stats.lookupProbes );
+						ARRRGH_STATS_TIMER( self.m_stats.lookupNanoseconds );
+						argument = self.find_argument( letter[ 0 ] );
+					}
+					
+					if( !argument )
+					{
+						return self.fail( parse_error::unknown_argument, letter );
+					}
+					return self.process_argument( *argument, letter, value, ownership );
+				}
+				
+				bool invalid_letter( std::string_view letter )
+				{
+					return self.fail( parse_error::invalid_argument_character, letter );
+				}
+				
+				bool unlabeled( std::string_view arg )
+				{
+					if( self.m_unlabeledSink )
+					{
+						self.m_unlabeledSink( arg );
+					}
+					else
+					{
+						self.m_unlabeledArguments.emplace_back( arg );
+					}
+					return true;
+				}
+			};
+			
+			handler h{ *this, ownership };
+			bool doneWithSwitches = false;
+			
+			for( int i = 1; i < argc; ++i )
+			{
+				assert( argv[ i ] );
+				const std::string_view arg{ argv[ i ] };
+				ARRRGH_STATS( ++m_stats.tokens );
+				
+				const bool isResponseFile = m_expandResponseFiles && !doneWithSwitches && arg.size() > 1 && arg[ 0 ] == '@';
+				
+				// The first unlabeled argument names the subcommand, which parses the rest.
+				//
+				if( !m_subcommands.empty() && !doneWithSwitches && !isResponseFile && ( arg.empty() || arg[ 0 ] != '-' ))
+				{
+					const parse_status status = parse_subcommand( argc - i, argv + i, i );
+					if( !status )
+					{
+						return status;
+					}
+					break;
+				}
+				
+				// Where the offset of any error in this argument is measured from.
+				//
+				const char* base = argv[ i ];
+				
+				const bool succeeded = isResponseFile
+					? read_response_file( argv[ i ] + 1, doneWithSwitches, h, base )
+					: detail::scan_argument( arg, doneWithSwitches, h );
+				
+				if( !succeeded )
+				{
+					return parse_status{ m_error, i, static_cast< uint32_t >( m_errorToken.data() - base ) };
+				}
+			}
+			
+			// Fill in what the command line didn't from the environment.
+			//
+			if( !m_environmentIndex.empty() || m_environmentPrefixSet )
+			{
+				uint32_t offset;
+				if( !read_environment( ownership, offset ))
+				{
+					return parse_status{ m_error, -1, offset };
+				}
+			}
+			
+			// ...and then from the config file.
+			//
+			if( !m_configPath.empty() )
+			{
+				uint32_t offset;
+				if( !read_config_file( ownership, offset ))
+				{
+					return parse_status{ m_error, -1, offset };
+				}
+			}
+			
+			// Did each of the *required* arguments get assigned?
+			//
+			{
+				ARRRGH_STATS_TIMER( m_stats.validationNanoseconds );
+				
+				if( m_requiredAssigned != required_count() )
+				{
+					m_error = parse_error::missing_required_arguments;
+					return parse_status{ m_error };
+				}
+			}
+			
+			// Did our help argument get set?
+			//
+			if( helpArg.value() )
+			{
+				show_usage();
+			}
+			
+			return parse_status{};
+		}
+		
+		// The values the last parse assigned, and its unlabeled arguments, in a compact binary form that
+		// load_values() reads back into a parser with the same arguments: a worker process can load what its
+		// supervisor parsed instead of parsing the command line again. Numbers and lists of numbers are saved as
+		// their bytes and copied straight back; other values are saved as text that converts back to them. A
+		// subcommand's values aren't included; save its parser's too.
+		//
+		// The form is versioned, and records fingerprint(), so that values saved by a build with different
+		// arguments are refused. It's in this machine's byte order.
+		//
+		std::string saved_values() const
+		{
+			std::string contents( sizeof( saved_values_header ), '\0' );
+			
+			const auto append_text = [&]( std::string_view text )
+			{
+				const uint64_t length = text.size();
+				contents.append( reinterpret_cast< const char* >( &length ), sizeof( length ));
+				contents.append( text ).push_back( '\0' );
+				contents.resize(( contents.size() + 7 ) & ~size_t( 7 ), '\0' );
+			};
+			
+			append_text( m_programExecutionPath );
+			
+			for( const argument_abstract* argument : m_assignedArguments )
+			{
+				const size_t entryOffset = contents.size();
+				contents.resize( entryOffset + sizeof( saved_values_entry ));
+				
+				saved_values_entry entry{ argument->m_index, 0, 0, 0 };
+				
+				std::string_view payload;
+				if( argument->value_bytes( argument->value_slot(), payload ))
+				{
+					entry.hasPayload = 1;
+					entry.textCount = 1;
+					entry.payloadLength = payload.size();
+					append_text( argument->value_view() );
+					contents.append( payload );
+					contents.resize(( contents.size() + 7 ) & ~size_t( 7 ), '\0' );
+				}
+				else
+				{
+					argument->each_value_text( [&]( std::string_view text )
+											   {
+												   ++entry.textCount;
+												   append_text( text );
+											   } );
+				}
+				std::memcpy( &contents[ entryOffset ], &entry, sizeof( entry ));
+			}
+			
+			for( const std::string_view& arg : m_unlabeledArguments )
+			{
+				append_text( arg );
+			}
+			
+			const saved_values_header header{ saved_values_header::expectedMagic,
+											  fingerprint(),
+											  contents.size(),
+											  m_assignedArguments.size(),
+											  m_unlabeledArguments.size() };
+			std::memcpy( &contents[ 0 ], &header, sizeof( header ));
+			return contents;
+		}
+		
+		// Assigns the values in saved, from saved_values(), as if the command line they came from had been parsed
+		// (but without the environment or config file, whose values are already among them). saved may be larger
+		// than the values, such as a whole shared memory region. With arrrgh::Borrow, values view saved, which
+		// must outlive them. Like parse(), use it on a parser whose values are clear.
+		//
+		void load_values( std::string_view saved, Ownership ownership = Copy )
+		{
+			const parse_status status = try_load_values( saved, ownership );
+			
+			if( !status )
+			{
+				throw_parse_error( status );
+			}
+		}
+		
+		// Maps the values saved in the file that descriptor refers to and loads them from there. The mapping lasts
+		// until clear_values(); the descriptor is left open.
+		//
+		void load_values( int descriptor )
+		{
+			const parse_status status = try_load_values( descriptor );
+			
+			if( !status )
+			{
+				throw_parse_error( status );
+			}
+		}
+		
+		// Like load_values(), but reports errors by returning them, as try_parse() does.
+		//
+		parse_status try_load_values( std::string_view saved, Ownership ownership = Copy )
+		{
+			clear_error();
+			
+			if( ownership == Copy )
+			{
+				std::pmr::string& text = next_text_block( saved.size() );
+				text.append( saved );
+				saved = text;
+			}
+			return read_saved_values( saved );
+		}
+		
+		parse_status try_load_values( int descriptor )
+		{
+			clear_error();
+			
+			m_responseFiles.emplace_back();
+			detail::mapped_file& file = m_responseFiles.back();
+			if( !file.open_descriptor( descriptor ))
+			{
+				m_responseFiles.pop_back();
+				m_error = parse_error::unreadable_saved_values;
+				return parse_status{ m_error };
+			}
+			return read_saved_values( { file.data(), file.size() } );
+		}
+		
+		// Describes a failed try_parse(), in the words parse() would have thrown. Call it before the parser parses
+		// again or clears its values.
+		//
+		std::string error_message( const parse_status& status ) const
+		{
+			if( m_failedSubcommand )
+			{
+				return m_failedSubcommand->error_message( status );
+			}
+			
+			switch( status.error )
+			{
+				case parse_error::none:
+					return {};
+				case parse_error::no_arguments:
+					return "Received no arguments.";
+				case parse_error::unknown_argument:
+				{
+					std::ostringstream message;
+					message << "Unrecognized argument \"" << ( m_errorToken.size() > 1 ? "" : "-" ) << m_errorToken << "\".";
+					m_suggestions.print( message, "--" );
+					return message.str();
+				}
+				case parse_error::invalid_argument_character:
+					return arrrgh_collect_string( "Invalid argument with character '" << m_errorToken << "'." );
+				case parse_error::missing_value:
+					return "Argument required a value but received none." + error_origin();
+				case parse_error::value_conversion:
+					return detail::conversion_error_message( m_errorValue, m_errorToken, m_errorArgument->allowed_values() ) + error_origin();
+				case parse_error::missing_required_arguments:
+					return missing_required_arguments_message( []( const argument_abstract& arg ) { return arg.assigned(); } );
+				case parse_error::unreadable_response_file:
+					return arrrgh_collect_string( "Could not read response file \"" << m_errorToken << "\"." );
+				case parse_error::unknown_subcommand:
+					return arrrgh_collect_string( "Unrecognized command \"" << m_errorToken << "\"." );
+				case parse_error::unreadable_config_file:
+					return arrrgh_collect_string( "Could not read config file \"" << m_errorToken << "\"." );
+				case parse_error::malformed_config_line:
+					return arrrgh_collect_string( "Expected \"key = value\" but found \"" << m_errorToken << "\"." << error_origin() );
+				case parse_error::unknown_config_key:
+				{
+					std::ostringstream message;
+					message << "Unrecognized argument \"" << m_errorToken << "\"." << error_origin();
+					m_suggestions.print( message, "" );
+					return message.str();
+				}
+				case parse_error::ambiguous_argument:
+				{
+					std::ostringstream message;
+					message << "Ambiguous argument \"" << m_errorToken << "\" could be";
+					
+					const auto matches = m_longFormTrie.starting_with( m_errorToken.substr( 2 ));
+					for( auto match = matches.first; match != matches.second; ++match )
+					{
+						message << ( match == matches.first ? " --" : match + 1 == matches.second ? " or --" : ", --" ) << match->first;
+					}
+					message << ".";
+					return message.str();
+				}
+				case parse_error::unreadable_saved_values:
+					return "Could not read saved values.";
+				case parse_error::mismatched_saved_values:
+					return "Saved values are for different arguments than this program's.";
+			}
+			return {};
+		}
+		
+		template< typename Function >
+		void each_unlabeled_argument( Function&& fn ) const
+		{
+			std::string arg;
+			for( const auto& view : m_unlabeledArguments )
+			{
+				arg.assign( view );
+				fn( arg );
+			}
+		}
+		
+		// Like each_unlabeled_argument(), but passes std::string_view and copies nothing.
+		//
+		template< typename Function >
+		void each_unlabeled_argument_view( Function&& fn ) const
+		{
+			std::for_each( m_unlabeledArguments.begin(), m_unlabeledArguments.end(), fn );
+		}
+		
+		void clear_values()
+		{
+			// Only the arguments that were assigned need clearing.
+			//
+			for( argument_abstract* arg : m_assignedArguments )
+			{
+				assert( arg );
+				arg->clear_value();
+			}
+			m_assignedArguments.clear();
+			m_requiredAssigned = 0;
+			
+			m_unlabeledArguments.clear();
+			m_argumentTextUsed = 0;
+			m_responseFiles.clear();
+			
+			if( m_activeSubcommand && m_activeSubcommand->built )
+			{
+				m_activeSubcommand->built->clear_values();
+			}
+			m_activeSubcommand = nullptr;
+		}
+		
+	private:
+		
+		struct subcommand
+		{
+			std::pmr::string name;
+			std::pmr::string description;
+			std::function< void( parser& ) > registration;
+			parser* built;
+		};
+		
+		subcommand* find_subcommand( std::string_view name )
+		{
+			const auto found = std::find_if( m_subcommands.begin(), m_subcommands.end(),
+											 [&]( const subcommand& command ) { return command.name == name; } );
+			return found != m_subcommands.end() ? &*found : nullptr;
+		}
+		
+		parser& build_subcommand( subcommand& command )
+		{
+			if( !command.built )
+			{
+				std::pmr::polymorphic_allocator< parser > allocator{ m_resource };
+				parser* const built = allocator.allocate( 1 );
+				
+				ARRRGH_TRY
+				{
+					new( built ) parser{ std::string( program_name() ) + " " + std::string( command.name ),
+										 command.description,
+										 m_resource };
+				}
+				ARRRGH_CATCH_ALL
+				{
+					allocator.deallocate( built, 1 );
+					ARRRGH_RETHROW;
+				}
+				
+				built->m_expandResponseFiles = m_expandResponseFiles;
+				
+				ARRRGH_TRY
+				{
+					command.registration( *built );
+				}
+				ARRRGH_CATCH_ALL
+				{
+					destroy_subcommand( built );
+					ARRRGH_RETHROW;
+				}
+				command.built = built;
+			}
+			return *command.built;
+		}
+		
+		void destroy_subcommand( parser* built )
+		{
+			std::pmr::polymorphic_allocator< parser > allocator{ m_resource };
+			built->~parser();
+			allocator.deallocate( built, 1 );
+		}
+		
+		// Has the subcommand named by argv[ 0 ], which was argv[ index ] of this parse, parse the rest of the command
+		// line. The text has already been copied, if it was going to be.
+		//
+		parse_status parse_subcommand( const int argc, const char* const argv[], const int index )
+		{
+			subcommand* const command = find_subcommand( argv[ 0 ] );
+			if( !command )
+			{
+				fail( parse_error::unknown_subcommand, argv[ 0 ] );
+				return parse_status{ m_error, index };
+			}
+			
+			// Only once it's built, so that a registration that throws leaves no subcommand active.
+			//
+			parser& built = build_subcommand( *command );
+			m_activeSubcommand = command;
+			
+			parse_status status = built.try_parse( argc, argv, Borrow );
+			if( !status )
+			{
+				m_failedSubcommand = &built;
+				if( status.argumentIndex >= 0 )
+				{
+					status.argumentIndex += index;
+				}
+			}
+			return status;
+		}
+		
+		// Forgets the last parse's error, before another parse or load.
+		//
+		void clear_error()
+		{
+			m_errorToken = {};
+			m_errorArgument = nullptr;
+			m_errorVariable = {};
+			m_errorConfigText = nullptr;
+			m_failedSubcommand = nullptr;
+			m_suggestions.clear();
+		}
+		
+		// Records why the parse failed and where: token views the text at fault. Always returns false.
+		//
+		bool fail( parse_error error, std::string_view token )
+		{
+			m_error = error;
+			m_errorToken = token;
+			return false;
+		}
+		
+		// Notes that argument is about to be assigned, for clear_values() and the check for required arguments.
+		//
+		void mark_assigned( argument_abstract& argument )
+		{
+			if( !argument.assigned() )
+			{
+				m_assignedArguments.push_back( &argument );
+				
+				if( argument.required() )
+				{
+					++m_requiredAssigned;
+				}
+			}
+		}
+		
+		// Assigns value to argument, which token (its switch) named.
+		//
+		bool process_argument( argument_abstract& argument,
+							   std::string_view token,
+							   std::string_view value,
+							   Ownership ownership )
+		{
+			// Note the argument before assigning it, since it counts as assigned even if its value is bad.
+			//
+			mark_assigned( argument );
+			
+			bool hasValue;
+			{
+				ARRRGH_STATS_TIMER( m_stats.assignNanoseconds );
+				hasValue = argument.assign( value );
+			}
+			
+			if( !hasValue )
+			{
+				return fail( parse_error::missing_value, token );
+			}
+			
+			ARRRGH_STATS_TIMER( m_stats.conversionNanoseconds );
+			
+			if( !argument.convert_value( ownership ))
+			{
+				ARRRGH_STATS( ++m_stats.conversionFailures );
+				m_errorArgument = &argument;
+				m_errorValue = value;
+				return fail( parse_error::value_conversion, argument.unconverted_part( value ));
+			}
+			return true;
+		}
+		
+		// Scans each entry of the response file at path, stopping at the first error. On success, errorBase is set
+		// to the start of the file's contents.
+		//
+		template< typename Handler >
+		bool read_response_file( const char* path, bool& doneWithSwitches, Handler& handler, const char*& errorBase )
+		{
+			m_responseFiles.emplace_back();
+			detail::mapped_file& file = m_responseFiles.back();
+			
+			if( !file.open( path ))
+			{
+				return fail( parse_error::unreadable_response_file, path );
+			}
+			
+			errorBase = file.data();
+			
+			bool succeeded = true;
+			detail::each_response_file_entry( file.data(), file.size(), [&]( std::string_view entry )
+											 {
+												 if( succeeded )
+												 {
+													 ARRRGH_STATS( ++m_stats.tokens );
+													 succeeded = detail::scan_argument( entry, doneWithSwitches, handler );
+												 }
+											 } );
+			return succeeded;
+		}
+		
+		[[noreturn]] void throw_parse_error( const parse_status& status ) const
+		{
+			if( m_failedSubcommand )
+			{
+				m_failedSubcommand->throw_parse_error( status );
+			}
+			
+			switch( status.error )
+			{
+				case parse_error::no_arguments:
+					ARRRGH_THROW( InvalidParameters{ error_message( status ) } );
+				case parse_error::unknown_argument:
+					ARRRGH_THROW( UnknownArgument{ error_message( status ) } );
+				case parse_error::invalid_argument_character:
+					ARRRGH_THROW( InvalidArgumentCharacter{ error_message( status ) } );
+				case parse_error::missing_value:
+					ARRRGH_THROW( argument_abstract::MissingValue{ error_message( status ) } );
+				case parse_error::value_conversion:
+					m_errorArgument->throw_conversion_error( error_message( status ));
+					break;
+				case parse_error::missing_required_arguments:
+					ARRRGH_THROW( MissingRequiredArguments{ error_message( status ) } );
+				case parse_error::unreadable_response_file:
+					ARRRGH_THROW( UnreadableResponseFile{ error_message( status ) } );
+				case parse_error::unknown_subcommand:
+					ARRRGH_THROW( UnknownSubcommand{ error_message( status ) } );
+				case parse_error::unreadable_config_file:
+					ARRRGH_THROW( UnreadableConfigFile{ error_message( status ) } );
+				case parse_error::malformed_config_line:
+					ARRRGH_THROW( MalformedConfigFile{ error_message( status ) } );
+				case parse_error::unknown_config_key:
+					ARRRGH_THROW( UnknownArgument{ error_message( status ) } );
+				case parse_error::ambiguous_argument:
+					ARRRGH_THROW( AmbiguousArgument{ error_message( status ) } );
+				case parse_error::unreadable_saved_values:
+					ARRRGH_THROW( UnreadableSavedValues{ error_message( status ) } );
+				case parse_error::mismatched_saved_values:
+					ARRRGH_THROW( MismatchedSavedValues{ error_message( status ) } );
+				case parse_error::none:
+					break;
+			}
+			assert( false );
+			std::abort();
+		}
+		
+		// Copies the argument text into the parser's own storage and returns pointers to the copies.
+		// Each parse() gets its own block of text so that values from an earlier parse() stay valid until
+		// clear_values(); blocks are kept and reused afterward.
+		//
+		const char** copy_arguments( const int argc, const char* const argv[] )
+		{
+			ARRRGH_STATS_TIMER( m_stats.copyNanoseconds );
+			
+			size_t totalLength = 0;
+			for( int i = 0; i < argc; ++i )
+			{
+				totalLength += std::strlen( argv[ i ] ) + 1;
+			}
+			
+			std::pmr::string& text = next_text_block( totalLength );
+			
+			m_argumentPointers.clear();
+			for( int i = 0; i < argc; ++i )
+			{
+				m_argumentPointers.push_back( text.data() + text.size() );
+				text.append( argv[ i ] );
+				text.push_back( '\0' );
+			}
+			
+			ARRRGH_STATS( m_stats.bytesCopied += totalLength );
+			
+			return m_argumentPointers.data();
+		}
+		
+		// A block of room for length bytes of copied text, which lasts until clear_values(). Blocks are reused
+		// afterward. Appending up to length bytes never moves what's already in it.
+		//
+		std::pmr::string& next_text_block( size_t length )
+		{
+			if( m_argumentTextUsed == m_argumentText.size() )
+			{
+				m_argumentText.emplace_back();
+			}
+			
+			std::pmr::string& text = m_argumentText[ m_argumentTextUsed++ ];
+			text.clear();
+			text.reserve( length );
+			return text;
+		}
+		
+		// Names the arguments added since last time by the environment prefix, if there is one.
+		//
+		void index_environment_names()
+		{
+			if( !m_environmentPrefixSet )
+			{
+				return;
+			}
+			
+			for( ; m_environmentIndexed < m_arguments.size(); ++m_environmentIndexed )
+			{
+				argument_abstract* const arg = m_arguments[ m_environmentIndexed ];
+				if( arg->m_longForm.empty() || arg->m_longForm == "help" )
+				{
+					continue;
+				}
+				
+				std::pmr::string& name = m_environmentNames.emplace_back( m_environmentPrefix );
+				for( const char c : arg->m_longForm )
+				{
+					name.push_back( c == '-' ? '_' : static_cast< char >( std::toupper( static_cast< unsigned char >( c ))));
+				}
+				
+				// Doesn't replace an explicit binding of the same name.
+				//
+				m_environmentIndex.emplace( name, environment_binding{ arg, false } );
+			}
+		}
+		
+		// Scans the environment once, looking each variable up among the bound names, and assigns the values of
+		// those whose arguments the command line didn't. On failure, offset is where in the value the trouble is.
+		//
+		bool read_environment( Ownership ownership, uint32_t& offset )
+		{
+			index_environment_names();
+			
+			m_environmentMatches.clear();
+			size_t totalLength = 0;
+			
+			const char* const* environment = m_environment ? m_environment : detail::process_environment();
+			for( ; environment && *environment; ++environment )
+			{
+				const char* const entry = *environment;
+				const char* const equals = std::strchr( entry, '=' );
+				if( !equals || equals[ 1 ] == '\0' )
+				{
+					continue;
+				}
+				
+				const auto found = m_environmentIndex.find( std::string_view( entry, static_cast< size_t >( equals - entry )));
+				if( found != m_environmentIndex.end() && !found->second.argument->assigned() )
+				{
+					const std::string_view value{ equals + 1 };
+					m_environmentMatches.push_back( { found->second, found->first, value } );
+					totalLength += value.size() + 1;
+				}
+			}
+			
+			if( m_environmentMatches.empty() )
+			{
+				return true;
+			}
+			
+			if( ownership == Copy )
+			{
+				std::pmr::string& text = next_text_block( totalLength );
+				for( auto& match : m_environmentMatches )
+				{
+					const char* const copy = text.data() + text.size();
+					text.append( match.value );
+					text.push_back( '\0' );
+					match.value = std::string_view( copy, match.value.size() );
+				}
+				ARRRGH_STATS( m_stats.bytesCopied += totalLength );
+			}
+			
+			// Explicit bindings first, so that they win over names made from the prefix.
+			//
+			for( const bool isExplicit : { true, false } )
+			{
+				for( const auto& match : m_environmentMatches )
+				{
+					if( match.binding.isExplicit == isExplicit && !match.binding.argument->assigned() &&
+					    !process_argument( *match.binding.argument, match.variable, match.value, ownership ))
+					{
+						m_errorVariable = match.variable;
+						offset = static_cast< uint32_t >( m_errorToken.data() - match.value.data() );
+						return false;
+					}
+				}
+			}
+			return true;
+		}
+		
+		// fingerprint(), recomputed only if arguments have been added since last time, for checking saved values
+		// on every parse or load.
+		//
+		uint64_t cached_fingerprint()
+		{
+			if( m_fingerprintArguments != m_arguments.size() )
+			{
+				m_fingerprint = fingerprint();
+				m_fingerprintArguments = m_arguments.size();
+			}
+			return m_fingerprint;
+		}
+		
+		// The trie of long forms, rebuilt if arguments have been added since it was last built.
+		//
+		const detail::name_trie< argument_abstract* >& long_form_trie()
+		{
+			if( m_trieArguments != m_arguments.size() )
+			{
+				std::pmr::vector< std::pair< std::string_view, argument_abstract* >> entries( m_resource );
+				for( argument_abstract* arg : m_arguments )
+				{
+					if( !arg->m_longForm.empty() )
+					{
+						entries.emplace_back( arg->m_longForm, arg );
+					}
+				}
+				
+				m_longFormTrie.build( entries.begin(), entries.end() );
+				m_trieArguments = m_arguments.size();
+			}
+			return m_longFormTrie;
+		}
+		
+		// Fills m_suggestions with the long forms nearest to an unknown one. The pattern's distance to each
+		// prefix in the trie is worked out once for all of the names that share it, and a subtree is passed over as
+		// soon as its prefix is too far off for any name in it to be near.
+		//
+		void suggest_from_trie( std::string_view longForm )
+		{
+			m_suggestions.clear();
+			if( longForm.empty() || longForm.size() > detail::edit_distance_pattern::maxLength )
+			{
+				return;
+			}
+			
+			const detail::edit_distance_pattern pattern( longForm );
+			const uint32_t limit = pattern.suggestion_limit();
+			
+			typedef detail::edit_distance_pattern::column column;
+			long_form_trie().walk( pattern.start(),
+								   [&]( column& current, char letter )
+								   {
+									   current = pattern.step( current, letter );
+									   return pattern.lower_bound( current ) <= limit;
+								   },
+								   [&]( const column& current, const std::pair< std::string_view, argument_abstract* >& entry )
+								   {
+									   if( current.distance <= limit )
+									   {
+										   m_suggestions.offer( entry.first, current.distance );
+									   }
+								   } );
+		}
+		
+		// Reads the config file's entries, from its cache if that's usable and from its text otherwise, and assigns
+		// those whose arguments are still unassigned. On failure, offset is where in the file the trouble is.
+		//
+		bool read_config_file( Ownership ownership, uint32_t& offset )
+		{
+			m_responseFiles.emplace_back();
+			detail::mapped_file& source = m_responseFiles.back();
+			
+			offset = 0;
+			if( !source.open( m_configPath.c_str() ))
+			{
+				return fail( parse_error::unreadable_config_file, m_configPath );
+			}
+			
+			const char* const text = source.data();
+			const uint64_t sourceHash = m_configCache ? detail::hash_bytes( text, source.size() ) : 0;
+			
+			// Errors are only ever reported against the text, never the cache.
+			//
+			const auto failInText = [&]()
+			{
+				m_errorConfigText = text;
+				offset = static_cast< uint32_t >( m_errorToken.data() - text );
+				return false;
+			};
+			
+			const bool cached = m_configCache && read_config_cache( source, sourceHash );
+			if( !cached && !read_config_text( text, source.size() ))
+			{
+				return failInText();
+			}
+			
+			bool fromCache = cached;
+			for( size_t i = 0; i < m_configEntries.size(); ++i )
+			{
+				const config_entry& entry = m_configEntries[ i ];
+				if( entry.overridden )
+				{
+					continue;
+				}
+				
+				if( entry.hasPayload )
+				{
+					mark_assigned( *entry.argument );
+					entry.argument->assign( entry.value );
+					entry.argument->restore_value( entry.payload );
+				}
+				else if( !process_argument( *entry.argument, entry.key, entry.value, ownership ))
+				{
+					if( fromCache )
+					{
+						// A conversion the cache recorded can fail now if it depends on more than the file's text
+						// (a path that must exist, say). Then the cache is dropped and this entry is tried again from
+						// the text, so that an error is reported against the file. The text is what the cache was
+						// made from, entry for entry, but the entries before this one are assigned now, so each keeps
+						// the cached one's overridden.
+						//
+						const std::pmr::vector< config_entry > cachedEntries( std::move( m_configEntries ));
+						if( !read_config_text( text, source.size() ))
+						{
+							return failInText();
+						}
+						assert( m_configEntries.size() == cachedEntries.size() );
+						
+						for( size_t j = 0; j < m_configEntries.size() && j < cachedEntries.size(); ++j )
+						{
+							m_configEntries[ j ].overridden = cachedEntries[ j ].overridden;
+						}
+						
+						fromCache = false;
+						--i;
+						continue;
+					}
+					return failInText();
+				}
+			}
+			
+			if( m_configCache && !cached )
+			{
+				write_config_cache( source, sourceHash );
+			}
+			return true;
+		}
+		
+		// Fills m_configEntries from the config file's text. Whether an argument was assigned is noted for every
+		// entry before any of them are, so that an argument given more than once in the file gets all of its values.
+		//
+		bool read_config_text( const char* text, size_t size )
+		{
+			m_configEntries.clear();
+			return detail::each_config_line( text, size, [&]( std::string_view line )
+				{
+					if( line.empty() || line[ 0 ] == '#' || line[ 0 ] == ';' )
+					{
+						return true;
+					}
+					
+					std::string_view key, value;
+					if( !detail::split_config_line( line, key, value ))
+					{
+						return fail( parse_error::malformed_config_line, line );
+					}
+					
+					argument_abstract* const argument = find_argument( key );
+					if( !argument )
+					{
+						suggest_from_trie( key );
+						return fail( parse_error::unknown_config_key, key );
+					}
+					
+					m_configEntries.push_back( { argument, key, value, {}, argument->assigned(), false } );
+					return true;
+				} );
+		}
+		
+		std::pmr::string config_cache_path() const
+		{
+			std::pmr::string path( m_configPath, m_resource );
+			path += ".cache";
+			return path;
+		}
+		
+		// Fills m_configEntries from the config file's cache, if there is one and it was made from the same
+		// source and arguments. Returns false, leaving m_configEntries empty, if not.
+		//
+		bool read_config_cache( const detail::mapped_file& source, uint64_t sourceHash )
+		{
+			m_responseFiles.emplace_back();
+			detail::mapped_file& cache = m_responseFiles.back();
+			
+			config_cache_header header;
+			bool usable = cache.open( config_cache_path().c_str() ) && cache.size() >= sizeof( header );
+			if( usable )
+			{
+				std::memcpy( &header, cache.data(), sizeof( header ));
+				usable = header.magic == config_cache_header::expectedMagic &&
+						 header.schemaFingerprint == cached_fingerprint() &&
+						 header.sourceSize == source.size() &&
+						 header.sourceModified == source.modification_time() &&
+						 header.sourceHash == sourceHash;
+			}
+			
+			const auto padded = []( uint64_t length ) { return ( length + 7 ) & ~uint64_t( 7 ); };
+			
+			m_configEntries.clear();
+			const char* p = cache.data() + sizeof( header );
+			const char* const end = cache.data() + cache.size();
+			
+			for( uint64_t i = 0; usable && i < header.entryCount; ++i )
+			{
+				config_cache_entry entry;
+				usable = static_cast< size_t >( end - p ) >= sizeof( entry );
+				if( !usable )
+				{
+					break;
+				}
+				std::memcpy( &entry, p, sizeof( entry ));
+				p += sizeof( entry );
+				
+				const uint64_t room = static_cast< uint64_t >( end - p );
+				usable = entry.argumentIndex < m_arguments.size() &&
+						 entry.textLength < room && padded( entry.textLength + 1 ) <= room &&
+						 p[ entry.textLength ] == '\0' &&
+						 padded( entry.payloadLength ) <= room - padded( entry.textLength + 1 );
+				if( !usable )
+				{
+					break;
+				}
+				
+				argument_abstract* const argument = m_arguments[ entry.argumentIndex ];
+				const std::string_view value{ p, entry.textLength };
+				p += padded( entry.textLength + 1 );
+				const std::string_view payload{ p, entry.payloadLength };
+				p += padded( entry.payloadLength );
+				
+				usable = !entry.hasPayload || payload_fits( *argument, entry.payloadLength );
+				m_configEntries.push_back( { argument, argument->m_longForm, value, payload, argument->assigned(), entry.hasPayload != 0 } );
+			}
+			
+			if( !usable || p != end )
+			{
+				m_configEntries.clear();
+				m_responseFiles.pop_back();
+				return false;
+			}
+			return true;
+		}
+		
+		// Whether a payload of length bytes could be argument's value_bytes(): one number, or a whole number of
+		// them for a list (see value_layout()).
+		//
+		static bool payload_fits( const argument_abstract& argument, uint64_t length )
+		{
+			const uint64_t layout = argument.value_layout();
+			const uint64_t numberSize = ( layout & 0xffff ) >> 2;
+			
+			return layout != 0 &&
+				   ( layout >> 16 != 0 ? length % numberSize == 0 : length == argument.value_size() );
+		}
+		
+		// Writes the config file's cache, if all of m_configEntries convert, to a temporary file that then
+		// replaces the cache. Any failure just leaves the cache as it was.
+		//
+		void write_config_cache( const detail::mapped_file& source, uint64_t sourceHash ) const
+		{
+			const config_cache_header header{ config_cache_header::expectedMagic,
+											  fingerprint(),
+											  source.size(),
+											  source.modification_time(),
+											  sourceHash,
+											  m_configEntries.size() };
+			
+			std::string contents( reinterpret_cast< const char* >( &header ), sizeof( header ));
+			const auto pad = [&]() { contents.resize(( contents.size() + 7 ) & ~size_t( 7 ), '\0' ); };
+			
+			for( const config_entry& entry : m_configEntries )
+			{
+				const argument_abstract& argument = *entry.argument;
+				
+				// Entries the command line or environment overrode were never converted, so convert each here.
+				//
+				if( entry.value.empty() && argument.required_value() )
+				{
+					return;
+				}
+				
+				void* const slot = m_resource->allocate( argument.value_size(), argument.value_alignment() );
+				const bool converted = argument.store_value( slot, entry.value, false );
+				
+				std::string_view payload;
+				const bool hasPayload = converted && argument.value_bytes( slot, payload );
+				
+				const config_cache_entry record{ argument.m_index,
+												 hasPayload,
+												 entry.value.size(),
+												 hasPayload ? payload.size() : 0 };
+				contents.append( reinterpret_cast< const char* >( &record ), sizeof( record ));
+				contents.append( entry.value ).push_back( '\0' );
+				pad();
+				if( hasPayload )
+				{
+					contents.append( payload );
+					pad();
+				}
+				
+				argument.destroy_value( slot );
+				m_resource->deallocate( slot, argument.value_size(), argument.value_alignment() );
+				
+				if( !converted )
+				{
+					return;
+				}
+			}
+			
+			// The temporary file is named for this process and write, so that processes starting at once don't
+			// write into each other's. Whichever renames last wins, with a whole cache either way.
+			//
+			static std::atomic< unsigned int > writes{ 0 };
+			const std::pmr::string path = config_cache_path();
+			std::pmr::string temporaryPath = path;
+			temporaryPath += arrrgh_collect_string( "." << detail::process_id() << "." << writes++ << ".tmp" );
+			
+			{
+				std::ofstream out( temporaryPath.c_str(), std::ios::binary | std::ios::trunc );
+				out.write( contents.data(), static_cast< std::streamsize >( contents.size() ));
+				if( !out.flush() )
+				{
+					out.close();
+					std::remove( temporaryPath.c_str() );
+					return;
+				}
+			}
+			
+			if( std::rename( temporaryPath.c_str(), path.c_str() ) != 0 )
+			{
+				std::remove( temporaryPath.c_str() );
+			}
+		}
+		
+		// Checks all of saved before assigning any of it, so that values that are damaged or for other arguments
+		// are refused whole.
+		//
+		parse_status read_saved_values( std::string_view saved )
+		{
+			const argument< bool >& helpArg = add_help_argument();
+			
+			saved_values_header header;
+			if( saved.size() < sizeof( header ))
+			{
+				m_error = parse_error::unreadable_saved_values;
+				return parse_status{ m_error };
+			}
+			std::memcpy( &header, saved.data(), sizeof( header ));
+			
+			if( header.magic != saved_values_header::expectedMagic || header.size < sizeof( header ) || header.size > saved.size() )
+			{
+				m_error = parse_error::unreadable_saved_values;
+				return parse_status{ m_error };
+			}
+			if( header.schemaFingerprint != cached_fingerprint() )
+			{
+				m_error = parse_error::mismatched_saved_values;
+				return parse_status{ m_error };
+			}
+			
+			const auto padded = []( uint64_t length ) { return ( length + 7 ) & ~uint64_t( 7 ); };
+			const char* const end = saved.data() + header.size;
+			
+			// Reads each part of saved in turn, assigning it if assign is set. Returns false at the first part that
+			// is malformed or runs past the end, or, when assigning, at a text that doesn't convert.
+			//
+			const auto walk = [&]( bool assign )
+			{
+				const char* p = saved.data() + sizeof( header );
+				
+				const auto read_text = [&]( std::string_view& text )
+				{
+					uint64_t length;
+					if( static_cast< size_t >( end - p ) < sizeof( length ))
+					{
+						return false;
+					}
+					std::memcpy( &length, p, sizeof( length ));
+					p += sizeof( length );
+					
+					const uint64_t room = static_cast< uint64_t >( end - p );
+					if( length >= room || padded( length + 1 ) > room || p[ length ] != '\0' )
+					{
+						return false;
+					}
+					text = { p, static_cast< size_t >( length ) };
+					p += padded( length + 1 );
+					return true;
+				};
+				
+				std::string_view text;
+				if( !read_text( text ))
+				{
+					return false;
+				}
+				if( assign )
+				{
+					m_programExecutionPath = text;
+				}
+				
+				for( uint64_t i = 0; i < header.entryCount; ++i )
+				{
+					saved_values_entry entry;
+					if( static_cast< size_t >( end - p ) < sizeof( entry ))
+					{
+						return false;
+					}
+					std::memcpy( &entry, p, sizeof( entry ));
+					p += sizeof( entry );
+					
+					if( entry.argumentIndex >= m_arguments.size() || ( entry.hasPayload && entry.textCount != 1 ))
+					{
+						return false;
+					}
+					argument_abstract& argument = *m_arguments[ entry.argumentIndex ];
+					
+					if( assign )
+					{
+						mark_assigned( argument );
+					}
+					
+					for( uint64_t t = 0; t < entry.textCount; ++t )
+					{
+						if( !read_text( text ))
+						{
+							return false;
+						}
+						if( assign )
+						{
+							argument.assign( text );
+							if( !entry.hasPayload && !argument.convert_value( Borrow ))
+							{
+								m_errorArgument = &argument;
+								m_errorValue = text;
+								return fail( parse_error::value_conversion, argument.unconverted_part( text ));
+							}
+						}
+					}
+					
+					if( entry.hasPayload )
+					{
+						if( padded( entry.payloadLength ) > static_cast< uint64_t >( end - p ) ||
+							!payload_fits( argument, entry.payloadLength ))
+						{
+							return false;
+						}
+						if( assign )
+						{
+							argument.restore_value( { p, static_cast< size_t >( entry.payloadLength ) } );
+						}
+						p += padded( entry.payloadLength );
+					}
+				}
+				
+				for( uint64_t i = 0; i < header.unlabeledCount; ++i )
+				{
+					if( !read_text( text ))
+					{
+						return false;
+					}
+					if( assign && m_unlabeledSink )
+					{
+						m_unlabeledSink( text );
+					}
+					else if( assign )
+					{
+						m_unlabeledArguments.emplace_back( text );
+					}
+				}
+				return p == end;
+			};
+			
+			if( !walk( false ))
+			{
+				m_error = parse_error::unreadable_saved_values;
+				return parse_status{ m_error };
+			}
+			if( !walk( true ))
+			{
+				return parse_status{ m_error };
+			}
+			
+			if( m_requiredAssigned != required_count() )
+			{
+				m_error = parse_error::missing_required_arguments;
+				return parse_status{ m_error };
+			}
+			
+			if( helpArg.value() )
+			{
+				show_usage();
+			}
+			return parse_status{};
+		}
 		
-		std::string m_value;
+		// Where the value at fault came from, if not the command line, to end an error message with.
+		//
+		std::string error_origin() const
+		{
+			if( !m_errorVariable.empty() )
+			{
+				return " (From environment variable " + std::string( m_errorVariable ) + ".)";
+			}
+			if( m_errorConfigText )
+			{
+				const auto line = 1 + std::count( m_errorConfigText, m_errorToken.data(), '\n' );
+				return arrrgh_collect_string( " (At line " << line << " of config file \"" << m_configPath << "\".)" );
+			}
+			return {};
+		}
 		
-		friend class parser;
+		std::pmr::memory_resource* parse_resource()
+		{
+#if ARRRGH_ENABLE_STATS
+			return &m_statsResource;
+#else
+			return m_resource;
+#endif
+		}
+		
+	private:
+		
+#if ARRRGH_ENABLE_STATS
+		// Declared first, so that it's constructed before the containers that allocate from it.
+		//
+		parse_stats m_stats;
+		detail::counting_resource m_statsResource;
+#endif
+		
+		std::string_view m_programExecutionPath;
+		std::pmr::vector< std::string_view > m_unlabeledArguments;
+		
+		// The arguments parse() has assigned since clear_values(), and how many of them are required.
+		//
+		std::pmr::vector< argument_abstract* > m_assignedArguments;
+		size_t m_requiredAssigned = 0;
+		
+		// Copies of argv made by parse() with arrrgh::Copy, which the views above point into. A deque, so that adding
+		// a block never moves the others.
+		//
+		std::pmr::deque< std::pmr::string > m_argumentText;
+		size_t m_argumentTextUsed = 0;
+		std::pmr::vector< const char* > m_argumentPointers;
+		
+		// Response files read by parse(), which values may view until clear_values().
+		//
+		std::pmr::deque< detail::mapped_file > m_responseFiles;
+		bool m_expandResponseFiles = false;
+		
+		std::function< void( std::string_view ) > m_unlabeledSink;
+		
+		// Why the last try_parse() failed, for error_message(). The token views argv, the copied text or a response
+		// file, all of which last until the next parse or clear_values().
+		//
+		parse_error m_error = parse_error::none;
+		std::string_view m_errorToken;
+		std::string_view m_errorValue;			// All of a value that didn't convert, of which m_errorToken is the bad part.
+		const argument_abstract* m_errorArgument = nullptr;
+		const parser* m_failedSubcommand = nullptr;		// Set if the error was the subcommand's.
+		std::string_view m_errorVariable;				// Set if the error was in the environment.
+		const char* m_errorConfigText = nullptr;		// Set to the file's text if the error was in the config file.
+		
+		std::pmr::vector< subcommand > m_subcommands;
+		subcommand* m_activeSubcommand = nullptr;
+		
+		// Environment variable bindings. The index's keys view m_environmentNames.
+		//
+		struct environment_binding
+		{
+			argument_abstract* argument;
+			bool isExplicit;
+		};
+		
+		struct environment_match
+		{
+			environment_binding binding;
+			std::string_view variable;
+			std::string_view value;
+		};
+		
+		const char* const* m_environment = nullptr;
+		std::pmr::string m_environmentPrefix;
+		bool m_environmentPrefixSet = false;
+		size_t m_environmentIndexed = 0;
+		std::pmr::deque< std::pmr::string > m_environmentNames;
+		std::pmr::unordered_map< std::string_view, environment_binding > m_environmentIndex;
+		std::pmr::vector< environment_match > m_environmentMatches;
+		
+		// The config file, and its entries as of the last parse. An entry is overridden if the command line or
+		// environment assigned its argument first.
+		//
+		struct config_entry
+		{
+			argument_abstract* argument;
+			std::string_view key;
+			std::string_view value;
+			std::string_view payload;		// The converted value's bytes, from the cache.
+			bool overridden;
+			bool hasPayload;
+		};
+		
+		// The config file cache format. The header is followed by entryCount entries, each followed by its
+		// text, NUL-terminated, and then its payload (the value_bytes() of its converted value, if it has them),
+		// each padded to a multiple of 8 bytes. All of it is in the writer's byte order, which the magic number
+		// rejects if the reader's is different.
+		//
+		struct config_cache_header
+		{
+			static constexpr uint64_t expectedMagic = 0x3143484752525241ull;		// "ARRRGHC1"
+			
+			uint64_t magic;
+			uint64_t schemaFingerprint;
+			uint64_t sourceSize;
+			int64_t sourceModified;
+			uint64_t sourceHash;
+			uint64_t entryCount;
+		};
+		
+		struct config_cache_entry
+		{
+			uint32_t argumentIndex;
+			uint32_t hasPayload;
+			uint64_t textLength;
+			uint64_t payloadLength;
+		};
+		
+		// The form of saved_values(). The header is followed by the program's execution path, then entryCount
+		// entries and then unlabeledCount unlabeled arguments. Each entry is followed by its textCount texts and
+		// then, if it has one, its payload, as in the config file cache. Each text is its length (a uint64_t)
+		// followed by its characters and a NUL. Everything is padded to a multiple of 8 bytes.
+		//
+		struct saved_values_header
+		{
+			static constexpr uint64_t expectedMagic = 0x3156484752525241ull;		// "ARRRGHV1"
+			
+			uint64_t magic;
+			uint64_t schemaFingerprint;
+			uint64_t size;
+			uint64_t entryCount;
+			uint64_t unlabeledCount;
+		};
+		
+		struct saved_values_entry
+		{
+			uint32_t argumentIndex;
+			uint32_t hasPayload;
+			uint64_t textCount;
+			uint64_t payloadLength;
+		};
+		
+		std::pmr::string m_configPath;
+		bool m_configCache = false;
+		std::pmr::vector< config_entry > m_configEntries;
+		
+		// fingerprint() as of when there were m_fingerprintArguments arguments, for cached_fingerprint().
+		//
+		uint64_t m_fingerprint = 0;
+		size_t m_fingerprintArguments = SIZE_MAX;
+		
+		// For abbreviations and completion. Built when first needed after arguments are added.
+		//
+		bool m_allowAbbreviations = false;
+		detail::name_trie< argument_abstract* > m_longFormTrie;
+		size_t m_trieArguments = 0;
+		
+		// Long forms near the unknown one, if that's why the last try_parse() failed. They view the arguments.
+		//
+		detail::suggestion_list m_suggestions;
 	};
 	
 	///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Specializations
+	//
+	template<>
+	inline bool argument< bool >::convert( std::string_view text, bool& result )
+	{
+		if( text.empty() )
+		{
+			result = true;	// Present with no value means true.
+			return true;
+		}
+		return detail::convert( text, result );
+	}
 	
-	template< typename ValueType >
-	class argument : public argument_abstract
+	// A std::string argument copies its text when parsed, even with arrrgh::Borrow, so that value() only ever
+	// reads and any number of threads may call it. To avoid the copy, read value_view() or use a
+	// std::string_view argument.
+	//
+	template<>
+	inline bool argument< std::string >::convert( std::string_view text, std::string& result )
 	{
-	public:
-		typedef ValueType value_t;
-		
-		// Exception types.
-		//
-		ARRRGH_EXCEPTION( ValueConversionError )
+		result.assign( text );
+		return true;
+	}
 
-		operator value_t() const
+	///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// arrrgh::type_traits
+	//
+	// A specialization may also provide
+	//
+	//		static bool parse( const char* first, const char* last, ValueT& result );
+	//
+	// to convert values without going through operator>>. It returns false if the text doesn't convert.
+	//
+	template<>
+	struct type_traits< bool >
+	{
+		static constexpr bool always_requires_value() { return false; }
+		static constexpr const char* name() { return "bool"; }
+		static bool parse( const char* first, const char* last, bool& result ) { return detail::parse_bool( first, last, result ); }
+	};
+
+	template<>
+	struct type_traits< std::string >
+	{
+		static constexpr bool always_requires_value() { return true; }
+		static constexpr const char* name() { return "string"; }
+		static bool parse( const char* first, const char* last, std::string& result ) { result.assign( first, last ); return true; }
+	};
+	
+	// Views the argument text rather than copying it, so it's only good as long as that text: argv with
+	// arrrgh::Borrow, or until clear_values() otherwise.
+	//
+	template<>
+	struct type_traits< std::string_view >
+	{
+		static constexpr bool always_requires_value() { return true; }
+		static constexpr const char* name() { return "string"; }
+		static bool parse( const char* first, const char* last, std::string_view& result )
+		{
+			result = std::string_view( first, static_cast< size_t >( last - first ));
+			return true;
+		}
+	};
+	
+	// A std::vector argument collects a value each time its switch appears ("-I a -I b", or "-vvv" for a
+	// vector of bool), in order. Values are appended to one contiguous vector--with std::string_view elements,
+	// without allocating per value. Any values given replace the default.
+	//
+	// A vector of numbers also takes comma-separated lists ("--weights=1.5,2,3"), converted straight into
+	// the vector.
+	//
+	template< typename ValueT >
+	struct type_traits< std::vector< ValueT >>
+	{
+		static constexpr bool always_requires_value() { return type_traits< ValueT >::always_requires_value(); }
+		static constexpr const char* name() { return type_traits< ValueT >::name(); }
+		static bool parse( const char* first, const char* last, std::vector< ValueT >& result )
 		{
-			value_t result = m_defaultValue;
+			if constexpr( detail::is_number_list< std::vector< ValueT >>::value )
+			{
+				return !detail::parse_number_list( first, last, result );
+			}
 			
-			if( m_assigned )
+			ValueT element{};
+			
+			if constexpr( std::is_same< ValueT, bool >::value )
 			{
-				std::istringstream stream( value_string() );
-				stream >> std::boolalpha >> result;
-				
-				if( stream.fail() )
+				if( first == last )
 				{
-					throw ValueConversionError{
-						arrrgh_collect_string( "Could not convert value '" << value_string()
-						<< "' to the desired argument type." )};
+					result.push_back( true );	// Present with no value means true.
+					return true;
 				}
 			}
 			
-			return result;
+			if( !detail::convert( std::string_view( first, static_cast< size_t >( last - first )), element ))
+			{
+				return false;
+			}
+			result.push_back( std::move( element ));
+			return true;
+		}
+	};
+	
+	template< typename ValueT >
+	struct number_type_traits
+	{
+		static constexpr bool always_requires_value() { return true; }
+		static constexpr const char* name()
+		{
+			return std::is_floating_point< ValueT >::value ? "number" :
+				   std::is_same< ValueT, size_t >::value ? "size_t" :
+				   std::is_signed< ValueT >::value ? "int" : "unsigned int";
 		}
+		static bool parse( const char* first, const char* last, ValueT& result ) { return detail::parse_number( first, last, result ); }
+	};
+	
+	template<> struct type_traits< float > : number_type_traits< float > {};
+	template<> struct type_traits< double > : number_type_traits< double > {};
+	template<> struct type_traits< long double > : number_type_traits< long double > {};
+	template<> struct type_traits< signed char > : number_type_traits< signed char > {};
+	template<> struct type_traits< unsigned char > : number_type_traits< unsigned char > {};
+	template<> struct type_traits< short > : number_type_traits< short > {};
+	template<> struct type_traits< unsigned short > : number_type_traits< unsigned short > {};
+	template<> struct type_traits< int > : number_type_traits< int > {};
+	template<> struct type_traits< unsigned int > : number_type_traits< unsigned int > {};
+	template<> struct type_traits< long > : number_type_traits< long > {};
+	template<> struct type_traits< unsigned long > : number_type_traits< unsigned long > {};
+	template<> struct type_traits< long long > : number_type_traits< long long > {};
+	template<> struct type_traits< unsigned long long > : number_type_traits< unsigned long long > {};
+	
+	///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// static_parser
+	//
+	// A parser whose entire option set is known at compile time. Each option is a constexpr arrrgh::option object
+	// with static storage duration; the parser is templated on references to them:
+	//
+	//		static constexpr arrrgh::option< int > height{ "height", "The height of the thing.", 'h', arrrgh::Required };
+	//		static constexpr arrrgh::option< bool > runFast{ "fast", "Should this program run fast?", 'f' };
+	//
+	//		arrrgh::static_parser< height, runFast > parser( "arrrghsample", "Parses a few arguments." );
+	//		parser.parse( argc, argv );
+	//		const int h = parser.value< height >();
+	//
+	// The matching tables are built at compile time, duplicate long or short forms fail a static_assert, and values
+	// are stored in place with no heap allocation. String values are views into argv, which must outlive the parser.
+	// Parsing follows the same rules as parser::parse().
+	//
+	template< typename ValueT >
+	struct option
+	{
+		typedef ValueT value_t;
+		typedef typename std::conditional< std::is_same< ValueT, std::string >::value,
+										   std::string_view,
+										   ValueT >::type storage_t;
 		
-		value_t value() const { return operator value_t(); }
+		constexpr option( std::string_view longForm_,
+						  std::string_view explanation_,
+						  char letter_ = '\0',
+						  Requirement requirement_ = Optional,
+						  storage_t defaultValue_ = storage_t{} )
+		:	longForm( longForm_ )
+		,	explanation( explanation_ )
+		,	letter( letter_ )
+		,	requirement( requirement_ )
+		,	defaultValue( defaultValue_ )
+		{}
 		
-	private:
+		std::string_view longForm;
+		std::string_view explanation;
+		char letter;
+		Requirement requirement;
+		storage_t defaultValue;
+	};
+	
+	namespace detail
+	{
+		template< size_t N >
+		constexpr bool has_unique_long_forms( const std::array< std::string_view, N >& longForms )
+		{
+			for( size_t i = 0; i < N; ++i )
+			{
+				for( size_t j = i + 1; j < N; ++j )
+				{
+					if( !longForms[ i ].empty() && longForms[ i ] == longForms[ j ] )
+					{
+						return false;
+					}
+				}
+			}
+			return true;
+		}
 		
-		value_t m_defaultValue = value_t{};
-
-		explicit argument( const std::string& longForm,
-						   const std::string& explanation,
-						   char letter,
-						   Requirement required,
-						   const value_t& defaultValue )
-		:	argument_abstract( longForm, explanation, letter, required )
-		,	m_defaultValue( defaultValue )
-		{}
+		template< size_t N >
+		constexpr bool has_unique_letters( const std::array< char, N >& letters )
+		{
+			for( size_t i = 0; i < N; ++i )
+			{
+				for( size_t j = i + 1; j < N; ++j )
+				{
+					if( letters[ i ] != '\0' && letters[ i ] == letters[ j ] )
+					{
+						return false;
+					}
+				}
+			}
+			return true;
+		}
 		
-		virtual std::string value_type_name() const override
+		template< size_t N >
+		constexpr bool has_valid_names( const std::array< std::string_view, N >& longForms,
+										const std::array< char, N >& letters )
 		{
-			return type_traits< value_t >::name();
+			for( size_t i = 0; i < N; ++i )
+			{
+				if( longForms[ i ].empty() && letters[ i ] == '\0' )
+				{
+					return false;		// Gotta specify at least one.
+				}
+				if( !longForms[ i ].empty() && longForms[ i ][ 0 ] == '-' )
+				{
+					return false;		// Don't start your switch names with -.
+				}
+				if( letters[ i ] != '\0' && !is_letter( letters[ i ] ))
+				{
+					return false;		// Has to be valid or nothing.
+				}
+			}
+			return true;
 		}
 		
-		virtual std::string converted_value_string() const override
+		template< size_t N >
+		constexpr std::array< int, 256 > make_letter_table( const std::array< char, N >& letters )
 		{
-			std::ostringstream stream;
-			stream << std::boolalpha << value();
-			return stream.str();
+			std::array< int, 256 > table{};
+			for( auto& entry : table )
+			{
+				entry = -1;
+			}
+			for( size_t i = 0; i < N; ++i )
+			{
+				if( letters[ i ] != '\0' )
+				{
+					table[ static_cast< unsigned char >( letters[ i ] ) ] = static_cast< int >( i );
+				}
+			}
+			return table;
+		}
+		
+		// Open-addressed hash table of long forms: a power of two at least twice the option count, linearly probed.
+		//
+		constexpr size_t long_form_table_size( size_t count )
+		{
+			size_t size = 2;
+			while( size < count * 2 )
+			{
+				size *= 2;
+			}
+			return size;
+		}
+		
+		template< size_t N >
+		constexpr bool contains( const std::array< std::string_view, N >& longForms, std::string_view longForm )
+		{
+			for( const auto& candidate : longForms )
+			{
+				if( candidate == longForm )
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+		
+		template< size_t TableSize, size_t N >
+		constexpr std::array< int, TableSize > make_long_form_table( const std::array< std::string_view, N >& longForms )
+		{
+			std::array< int, TableSize > table{};
+			for( auto& entry : table )
+			{
+				entry = -1;
+			}
+			for( size_t i = 0; i < N; ++i )
+			{
+				if( !longForms[ i ].empty() )
+				{
+					size_t slot = hash( longForms[ i ] ) & ( TableSize - 1 );
+					while( table[ slot ] >= 0 )
+					{
+						slot = ( slot + 1 ) & ( TableSize - 1 );
+					}
+					table[ slot ] = static_cast< int >( i );
+				}
+			}
+			return table;
+		}
+		
+		// The matching table for the names in an enum's choice_traits, built at compile time like static_parser's.
+		//
+		template< typename EnumT >
+		struct choice_table
+		{
+			static constexpr auto& choices = choice_traits< EnumT >::choices;
+			static constexpr size_t count = std::tuple_size< std::decay_t< decltype( choices ) >>::value;
+			
+			static constexpr std::array< std::string_view, count > make_names()
+			{
+				std::array< std::string_view, count > names{};
+				for( size_t i = 0; i < count; ++i )
+				{
+					names[ i ] = choices[ i ].first;
+				}
+				return names;
+			}
+			
+			static constexpr std::array< std::string_view, count > names = make_names();
+			
+			static_assert( count > 0 && !contains( names, "" ) && has_unique_long_forms( names ),
+						   "Each choice needs a name, and no two may have the same one." );
+			
+			static constexpr size_t tableSize = long_form_table_size( count );
+			static constexpr std::array< int, tableSize > table = make_long_form_table< tableSize >( names );
+			
+			static bool find( std::string_view name, EnumT& result )
+			{
+				size_t slot = hash( name ) & ( tableSize - 1 );
+				
+				for( int index = table[ slot ]; index >= 0; index = table[ slot ] )
+				{
+					if( names[ index ] == name )
+					{
+						result = choices[ index ].second;
+						return true;
+					}
+					slot = ( slot + 1 ) & ( tableSize - 1 );
+				}
+				return false;
+			}
+			
+			static const std::string& joined()
+			{
+				static const std::string text = []()
+				{
+					std::string result;
+					for( const auto& name : names )
+					{
+						result.append( result.empty() ? "" : "|" ).append( name );
+					}
+					return result;
+				}();
+				return text;
+			}
+		};
+		
+		template< typename ValueT >
+		std::string_view allowed_values()
+		{
+			if constexpr( has_choices< ValueT >::value )
+			{
+				return choice_table< ValueT >::joined();
+			}
+			return {};
 		}
 		
-		virtual bool has_default_value() const override
+		template< typename ValueT >
+		std::string_view choice_name( const ValueT& value )
 		{
-			return value() == m_defaultValue;
+			for( const auto& choice : choice_traits< ValueT >::choices )
+			{
+				if( choice.second == value )
+				{
+					return choice.first;
+				}
+			}
+			return {};
 		}
-		
-		virtual bool required_value() const override
+	}
+	
+	template< typename EnumT >
+	struct type_traits< EnumT, std::enable_if_t< detail::has_choices< EnumT >::value >>
+	{
+		static constexpr bool always_requires_value() { return true; }
+		static const char* name() { return detail::choice_table< EnumT >::joined().c_str(); }
+		static bool parse( const char* first, const char* last, EnumT& result )
 		{
-			return type_traits< value_t >::always_requires_value();
+			return detail::choice_table< EnumT >::find( std::string_view( first, static_cast< size_t >( last - first )), result );
 		}
-
-		friend class parser;
 	};
 	
-	///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-		
-	class parser
+	template< const auto&... Options >
+	class static_parser
 	{
 	public:
 		
-		// Exception classes.
-		//
-		ARRRGH_EXCEPTION( InvalidParameters )
-		ARRRGH_EXCEPTION( UnknownArgument )
-		ARRRGH_EXCEPTION( FoundDoubleHyphensLeadingNowhere )
-		ARRRGH_EXCEPTION( InvalidArgumentCharacter )
-		ARRRGH_EXCEPTION( MissingRequiredArguments )
+		static constexpr size_t count = sizeof...( Options );
 		
-		explicit parser( const std::string& programName, const std::string& programDescription )
+		explicit static_parser( std::string_view programName, std::string_view programDescription )
 		:	m_program( programName )
 		,	m_description( programDescription )
 		{}
-
-		template< typename ValueT >
-		argument< ValueT >& add( const std::string& longForm,
-								 const std::string& explanation,
-								 char letter = '\0',
-								 Requirement required = Optional,
-								 const ValueT& defaultValue = ValueT{} )
-		{
-			// Verify that no other argument has this longForm or letter.
-			//
-			assert( !has_long_form_argument( longForm ));
-			assert( !has_letter_argument( letter ));
-			
-			argument< ValueT >* arg = new argument< ValueT >{
-				longForm,
-				explanation,
-				letter,
-				required,
-				defaultValue };
-			
-			m_arguments.emplace_back( arg );
-			
-			return *arg;
-		}
-		
-		bool has_long_form_argument( const std::string& longForm ) const
-		{
-			return std::any_of( m_arguments.begin(), m_arguments.end(),
-						[&]( const std::unique_ptr< argument_abstract >& arg )
-						{
-							assert( arg );
-							return arg->has_long_form( longForm );
-						} );
-		}
-		
-		bool has_letter_argument( char letter ) const
-		{
-			return std::any_of( m_arguments.begin(), m_arguments.end(),
-							   [&]( const std::unique_ptr< argument_abstract >& arg )
-							   {
-								   assert( arg );
-								   return arg->has_short_form( letter );
-							   } );
-		}
 		
-		void parse( const int argc, const char* argv[] )
+		void parse( const int argc, const char* const argv[] )
 		{
 			if( argc == 0 || !argv )
 			{
-				throw InvalidParameters{ "Received no arguments." };
-			}
-
-			// If there's no help argument, add one.
-			//
-			if( !has_long_form_argument( "help" ))
-			{
-				add< bool >( "help",
-							 "Prints this help message.",
-							 !has_letter_argument( 'h' ) ? 'h' : '\0' );
+				ARRRGH_THROW( parser::InvalidParameters{ "Received no arguments." } );
 			}
 			
-			auto iterHelpArg = std::find_if( m_arguments.begin(), m_arguments.end(), []( const std::unique_ptr< argument_abstract >& arg )
-										 {
-											 return arg->has_long_form( "help" );
-										 } );
-			assert( m_arguments.end() != iterHelpArg );
-			
-			const argument< bool >& helpArg = *static_cast< const argument< bool >* >( iterHelpArg->get() );
-			
-			m_programExecutionPath = argv[ 0 ];
-			
-			bool doneWithSwitches = false;		// When false, still looking for switches. When true, all arguments
-												// are considered "unlabeled."
+			m_argc = argc;
+			m_argv = argv;
 			
-			for( int i = 1; i < argc; ++i )
+			struct handler
 			{
-				assert( argv[ i ] );
-				
-				const std::string arg{ argv[ i ] };
-				assert( !arg.empty() );
+				static_parser& self;
 				
-				// Determine which configured argument corresponds to this program argument, if any,
-				// and parse any value it might have.
+				bool long_form( std::string_view key, std::string_view value )
+				{
+					const int index = find_long_form( key );
+					
+					if( index >= 0 )
+					{
+						( self.*s_assigners[ index ] )( value );
+					}
+					else if( s_helpIsImplicit && key == "help" )
+					{
+						self.m_helpRequested = true;
+					}
+					else
+					{
+						ARRRGH_THROW( parser::UnknownArgument{ arrrgh_collect_string( "Unrecognized argument \"--" << key << "\"." ) } );
+					}
+					return true;
+				}
 				
-				// Do we have a leading hyphen?
-				//
-				if( !doneWithSwitches && arg[ 0 ] == '-' )
+				bool letter( std::string_view letter, std::string_view value )
 				{
-					// Yes we do.
+					const char c = letter[ 0 ];
+					const int index = s_letterTable[ static_cast< unsigned char >( c ) ];
 					
-					// Do we have two?
-					//
-					if( arg.size() > 1 && arg[ 1 ] == '-' )
+					if( index >= 0 )
 					{
-						// Yes. So we're expecting a long-form argument.
-						
-						// Read to the end or to the = sign.
-						//
-						const auto keyEnd = arg.find_first_of( '=' );
-						
-						const auto key = arg.substr( 2, keyEnd - 2 );
-						
-						std::string value;
-						
-						if( keyEnd < arg.size() )
-						{
-							value = arg.substr( keyEnd + 1 );
-						}
-						
-						if( key.empty() )
-						{
-							// This is either "--" or, more troublingly, "--=..."
-							
-							// Either way, don't look for arguments any more:
-							// anything else is "unlabeled."
-							//
-							doneWithSwitches = true;
-							continue;
-						}
-						
-						// Find this argument.
-						//
-						auto& argument = find_matching_argument( key, true /* long form */ );
-						process_argument( argument, arg, std::move( value ));
+						( self.*s_assigners[ index ] )( value );
+					}
+					else if( s_helpIsImplicit && c == 'h' )
+					{
+						self.m_helpRequested = true;
 					}
 					else
 					{
-						// No we don't. Just one.
-						
-						// Consider each following letter to be a short-form argument letter.
-						//
-						for( size_t i = 1; i < arg.size(); ++i )
-						{
-							const char c = arg[ i ];
-							
-							// Is this a reasonable argument character?
-							//
-							if( argument_abstract::is_valid_short_form( c ))
-							{
-								// This is a legitimate argument.
-								
-								// Does it have a value?
-								//
-								std::string value;
-								bool hasAssignment = i + 1 < arg.size() && arg[ i + 1 ] == '=';
-								if( hasAssignment )
-								{
-									// Looks like it. Read it.
-									//
-									value = arg.substr( i + 2 );
-								}
-								
-								auto& argument = find_matching_argument( std::string{ c }, false /* short form */ );
-								process_argument( argument, arg, std::move( value ));
-								
-								if( hasAssignment )
-								{
-									break;
-								}
-							}
-							else
-							{
-								throw InvalidArgumentCharacter{
-									arrrgh_collect_string( "Invalid argument with character '" << c << "'." ) };
-							}
-						}
+						ARRRGH_THROW( parser::UnknownArgument{ arrrgh_collect_string( "Unrecognized argument \"-" << c << "\"." ) } );
 					}
+					return true;
 				}
-				else
+				
+				bool invalid_letter( std::string_view letter )
 				{
-					// No we don't. This is an unlabeled argument.
-					//
-					m_unlabeledArguments.emplace_back( std::move( arg ));
+					ARRRGH_THROW( parser::InvalidArgumentCharacter{
+						arrrgh_collect_string( "Invalid argument with character '" << letter << "'." ) } );
 				}
-			}
+				
+				bool unlabeled( std::string_view )
+				{
+					// Unlabeled arguments are found again by walking argv in each_unlabeled_argument().
+					return true;
+				}
+			};
+			
+			detail::scan_arguments( argc, argv, handler{ *this } );
 			
 			// Did each of the *required* arguments get assigned?
 			//
-			if( std::any_of( m_arguments.begin(), m_arguments.end(),
-							[&]( const std::unique_ptr< argument_abstract >& arg )
-							{
-								assert( arg );
-								return !arg->assigned() && arg->required();
-							} ))
+			for( size_t i = 0; i < count; ++i )
 			{
-				throw MissingRequiredArguments{ "Some required arguments were missing." };
+				if( s_requirements[ i ] == Required && !m_assigned[ i ] )
+				{
+					ARRRGH_THROW( parser::MissingRequiredArguments{ missing_required_arguments_message() } );
+				}
 			}
 			
-			// Did our help argument get set?
-			//
-			if( helpArg.value() )
+			if( m_helpRequested )
 			{
 				show_usage();
 			}
 		}
 		
+		template< const auto& Option >
+		bool assigned() const
+		{
+			return m_assigned[ index_of< Option >() ];
+		}
+		
+		template< const auto& Option >
+		const auto& value() const
+		{
+			return std::get< index_of< Option >() >( m_values );
+		}
+		
+		template< typename Function >
+		void each_unlabeled_argument( Function&& fn ) const
+		{
+			struct handler
+			{
+				Function& fn;
+				
+				bool long_form( std::string_view, std::string_view ) { return true; }
+				bool letter( std::string_view, std::string_view ) { return true; }
+				bool invalid_letter( std::string_view ) { return true; }
+				bool unlabeled( std::string_view arg ) { fn( arg ); return true; }
+			};
+			
+			detail::scan_arguments( m_argc, m_argv, handler{ fn } );
+		}
+		
+		void clear_values()
+		{
+			m_values = values_t{ Options.defaultValue... };
+			m_assigned = {};
+			m_helpRequested = false;
+			m_argc = 0;
+			m_argv = nullptr;
+		}
+		
 		void show_usage( std::ostream& out = std::cout ) const
 		{
 			out << m_program << ": " << m_description << std::endl;
 			out << "usage: " << m_program << std::endl;
 			
-			for( const auto& arg : m_arguments )
+			( print_option( out, Options ), ... );
+			
+			if( s_helpIsImplicit )
 			{
-				assert( arg );
-				arg->print( out );
+				detail::print_usage_line( out,
+										  s_letterTable[ 'h' ] < 0 ? 'h' : '\0',
+										  "help",
+										  false,
+										  type_traits< bool >::name(),
+										  Optional,
+										  "Prints this help message." );
 				out << std::endl;
 			}
 			out << std::endl;
 		}
 		
-		template< typename Function >
-		void each_argument( Function&& fn ) const
+	private:
+		
+		typedef std::tuple< typename std::decay_t< decltype( Options ) >::storage_t... > values_t;
+		typedef void ( static_parser::*assigner_t )( std::string_view );
+		
+		static constexpr std::array< std::string_view, count > s_longForms{{ Options.longForm... }};
+		static constexpr std::array< char, count > s_letters{{ Options.letter... }};
+		static constexpr std::array< Requirement, count > s_requirements{{ Options.requirement... }};
+		
+		static_assert( detail::has_valid_names( s_longForms, s_letters ),
+					  "Each option needs a long form or a letter, long forms may not start with '-', "
+					  "and letters must be alphabetic." );
+		static_assert( detail::has_unique_long_forms( s_longForms ), "Two options have the same long form." );
+		static_assert( detail::has_unique_letters( s_letters ), "Two options have the same letter." );
+		
+		static constexpr std::array< int, 256 > s_letterTable = detail::make_letter_table( s_letters );
+		
+		static constexpr size_t s_longFormTableSize = detail::long_form_table_size( count );
+		static constexpr std::array< int, s_longFormTableSize > s_longFormTable =
+			detail::make_long_form_table< s_longFormTableSize >( s_longForms );
+		
+		// If no option claims "--help", parse() provides one (with -h, if that's free) just as parser does.
+		//
+		static constexpr bool s_helpIsImplicit = !detail::contains( s_longForms, "help" );
+		
+		template< size_t... Indices >
+		static constexpr std::array< assigner_t, count > make_assigners( std::index_sequence< Indices... > )
 		{
-			std::for_each( m_arguments.begin(), m_arguments.end(),
-						  [&]( const std::unique_ptr< argument_abstract >& arg )
-						  {
-							  assert( arg );
-							  fn( *arg );
-						  } );
+			return {{ &static_parser::assign< Indices >... }};
 		}
 		
-
-		template< typename Function >
-		void each_unlabeled_argument( Function&& fn ) const
+		static constexpr std::array< assigner_t, count > s_assigners =
+			make_assigners( std::index_sequence_for< decltype( Options )... >{} );
+		
+		template< const auto& Option >
+		static constexpr size_t index_of()
 		{
-			std::for_each( m_unlabeledArguments.begin(), m_unlabeledArguments.end(), fn );
+			constexpr std::array< const void*, count > addresses{{ static_cast< const void* >( &Options )... }};
+			size_t index = 0;
+			while( index < count && addresses[ index ] != static_cast< const void* >( &Option ))
+			{
+				++index;
+			}
+			return index;
 		}
 		
-		void clear_values()
+		static int find_long_form( std::string_view key )
 		{
-			std::for_each( m_arguments.begin(), m_arguments.end(),
-						  []( const std::unique_ptr< argument_abstract >& arg )
-						  {
-							  assert( arg );
-							  arg->clear_value();
-						  } );
+			size_t slot = detail::hash( key ) & ( s_longFormTableSize - 1 );
 			
-			m_unlabeledArguments.clear();
+			for( int index = s_longFormTable[ slot ]; index >= 0; index = s_longFormTable[ slot ] )
+			{
+				if( s_longForms[ index ] == key )
+				{
+					return index;
+				}
+				slot = ( slot + 1 ) & ( s_longFormTableSize - 1 );
+			}
+			return -1;
 		}
 		
-	protected:
+		// Names every required option that wasn't assigned, in the same form parser uses.
+		//
+		std::string missing_required_arguments_message() const
+		{
+			std::string message = "Missing required arguments:";
+			
+			const char* separator = " ";
+			for( size_t i = 0; i < count; ++i )
+			{
+				if( s_requirements[ i ] == Required && !m_assigned[ i ] )
+				{
+					message.append( separator );
+					if( s_longForms[ i ].empty() )
+					{
+						message.append( "-" ).push_back( s_letters[ i ] );
+					}
+					else
+					{
+						message.append( "--" ).append( s_longForms[ i ] );
+					}
+					separator = ", ";
+				}
+			}
+			message.append( "." );
+			
+			return message;
+		}
 		
-		argument_abstract& find_matching_argument( const std::string& argString, bool longForm )
+		template< size_t Index >
+		void assign( std::string_view valueString )
 		{
-			auto iterFound = std::find_if( m_arguments.begin(), m_arguments.end(),
-										  [&]( const std::unique_ptr< argument_abstract >& arg )
-										  {
-											  assert( arg );
-											  if( longForm )
-											  {
-												  return arg->has_long_form( argString );
-											  }
-											  else
-											  {
-												  return arg->has_short_form( argString[ 0 ] );
-											  }
-											
-										  } );
+			typedef typename std::tuple_element< Index, std::tuple< std::decay_t< decltype( Options ) >... >>::type option_t;
+			typedef typename option_t::value_t value_t;
 			
-			if( iterFound != m_arguments.end() )
+			m_assigned[ Index ] = true;
+			
+			if( valueString.empty() && type_traits< value_t >::always_requires_value() )
 			{
-				return **iterFound;
+				ARRRGH_THROW( argument_abstract::MissingValue{ arrrgh_collect_string( "Argument required a value but received none." ) } );
 			}
-			else
+			
+			auto& value = std::get< Index >( m_values );
+			
+			if constexpr( std::is_same< value_t, bool >::value )
+			{
+				value = true;		// Present with no value means true.
+			}
+			
+			if constexpr( std::is_same< value_t, std::string >::value )
+			{
+				value = valueString;
+			}
+			else if( !valueString.empty() && !detail::convert( valueString, value ))
 			{
-				throw UnknownArgument{ arrrgh_collect_string( "Unrecognized argument \"-" << ( longForm ? "-" : "" )
-															 << argString << "\"." ) };
+				ARRRGH_THROW( typename argument< value_t >::ValueConversionError{
+					detail::conversion_error_message( valueString, valueString, detail::allowed_values< value_t >() )} );
 			}
 		}
 		
-		void process_argument( argument_abstract& argument, const std::string& key, std::string&& value )
+		template< typename OptionT >
+		static void print_option( std::ostream& out, const OptionT& option )
 		{
-			argument.assign( key, std::move( value ));
+			typedef typename OptionT::value_t value_t;
+			
+			detail::print_usage_line( out,
+									  option.letter,
+									  option.longForm,
+									  type_traits< value_t >::always_requires_value(),
+									  type_traits< value_t >::name(),
+									  option.requirement,
+									  option.explanation );
+			out << std::endl;
 		}
 		
-	private:
-
-		std::string m_program;
-		std::string m_description;
-		std::string m_programExecutionPath;
-		std::vector< std::unique_ptr< argument_abstract >> m_arguments;
-		std::vector< std::string > m_unlabeledArguments;
-	};
-	
-	///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-	// Specializations
-	//
-	template<>
-	inline argument< bool >::operator bool() const
-	{
-		return m_assigned || m_defaultValue;
-	}
-
-	template<>
-	inline argument< std::string >::operator std::string() const
-	{
-		return m_assigned ? value_string() : m_defaultValue;
-	}
-
-	///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-	// arrrgh::type_traits
-	//
-	template<>
-	struct type_traits< bool >
-	{
-		static constexpr bool always_requires_value() { return false; }
-		static constexpr const char* name() { return "bool"; }
-	};
-
-	template<>
-	struct type_traits< std::string >
-	{
-		static constexpr bool always_requires_value() { return true; }
-		static constexpr const char* name() { return "string"; }
-	};
-	
-	template<>
-	struct type_traits< float >
-	{
-		static constexpr bool always_requires_value() { return true; }
-		static constexpr const char* name() { return "number"; }
-	};
-	
-	template<>
-	struct type_traits< double >
-	{
-		static constexpr bool always_requires_value() { return true; }
-		static constexpr const char* name() { return "number"; }
-	};
-	
-	template<>
-	struct type_traits< int >
-	{
-		static constexpr bool always_requires_value() { return true; }
-		static constexpr const char* name() { return "int"; }
-	};
-
-	template<>
-	struct type_traits< size_t >
-	{
-		static constexpr bool always_requires_value() { return true; }
-		static constexpr const char* name() { return "size_t"; }
+		std::string_view m_program;
+		std::string_view m_description;
+		
+		values_t m_values{ Options.defaultValue... };
+		std::array< bool, count > m_assigned{};
+		bool m_helpRequested = false;
+		
+		int m_argc = 0;
+		const char* const* m_argv = nullptr;
 	};
 	
 #undef arrrgh_collect_string
 #undef ARRRGH_EXCEPTION
+#undef ARRRGH_SSE2
+#undef ARRRGH_LITTLE_ENDIAN
+#undef ARRRGH_MMAP
+#undef ARRRGH_FLOAT_FROM_CHARS
+#undef ARRRGH_STATS
+#undef ARRRGH_STATS_TIMER
+#undef ARRRGH_THROW
+#undef ARRRGH_TRY
+#undef ARRRGH_CATCH_ALL
+#undef ARRRGH_RETHROW
+#undef ARRRGH_CONFIG_NAMESPACE
 
+}
 }
 
 #endif
@@ -0,0 +1,706 @@
+//
+//  bench_arrrgh.cpp
+//
+//  Measures parse throughput, value access, reuse and startup costs, and compares parsing against getopt_long.
+//  Results go to bench_output.txt as CSV, one measurement per line, so that runs can be compared across versions.
+//
+//  Build with optimizations, e.g.:
+//
+//		c++ -std=c++17 -O2 -pthread bench_arrrgh.cpp -o bench_arrrgh && ./bench_arrrgh
+//
+
+#include "arrrgh.hpp"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined( __unix__ ) || defined( __APPLE__ )
+#	include <getopt.h>
+#	include <spawn.h>
+#	include <sys/wait.h>
+#	define HAVE_POSIX 1
+extern char** environ;
+#else
+#	define HAVE_POSIX 0
+#endif
+
+namespace
+{
+	typedef std::chrono::steady_clock clock_type;
+
+	// Keeps the compiler from optimizing away a value that nothing else reads.
+	//
+	template< typename T >
+	void do_not_optimize( const T& value )
+	{
+#if defined( __GNUC__ )
+		asm volatile( "" : : "g"( &value ) : "memory" );
+#else
+		static volatile const void* sink;
+		sink = &value;
+#endif
+	}
+
+	// Runs fn in growing batches until at least minimumSeconds have passed and returns nanoseconds per call.
+	//
+	template< typename Function >
+	double time_per_call( Function&& fn, double minimumSeconds = 0.2 )
+	{
+		fn();	// Warm up.
+
+		size_t iterations = 1;
+		for( ;; )
+		{
+			const auto start = clock_type::now();
+			for( size_t i = 0; i < iterations; ++i )
+			{
+				fn();
+			}
+			const double seconds = std::chrono::duration< double >( clock_type::now() - start ).count();
+
+			if( seconds >= minimumSeconds )
+			{
+				return seconds * 1e9 / iterations;
+			}
+			iterations *= 2;
+		}
+	}
+
+	class report
+	{
+	public:
+
+		explicit report( const char* path )
+		:	m_out( path )
+		{
+			m_out << "benchmark,variant,options,value,unit\n";
+		}
+
+		void add( const std::string& benchmark, const std::string& variant, size_t options, double value, const char* unit )
+		{
+			m_out << benchmark << "," << variant << "," << options << "," << value << "," << unit << "\n";
+			std::cout << benchmark << " " << variant << " (" << options << " options): " << value << " " << unit << std::endl;
+		}
+
+	private:
+
+		std::ofstream m_out;
+	};
+
+	// An argv held as strings, with the pointers parse() wants.
+	//
+	struct command_line_text
+	{
+		std::vector< std::string > args;
+		std::vector< const char* > argv;
+
+		explicit command_line_text( std::vector< std::string > arguments )
+		:	args( std::move( arguments ))
+		{
+			for( const auto& arg : args )
+			{
+				argv.push_back( arg.c_str() );
+			}
+			argv.push_back( nullptr );
+		}
+
+		int argc() const { return static_cast< int >( args.size() ); }
+	};
+
+	std::string option_name( size_t i )
+	{
+		return "option-" + std::to_string( i );
+	}
+
+	char option_letter( size_t i )
+	{
+		return i < 26 ? static_cast< char >( 'a' + i ) : static_cast< char >( 'A' + i - 26 );
+	}
+
+	// Every option is an int, except the first few, which are lettered bools so that there's something to cluster.
+	//
+	constexpr size_t letteredOptions = 16;
+
+	void add_options( arrrgh::schema& schema, size_t optionCount )
+	{
+		for( size_t i = 0; i < optionCount; ++i )
+		{
+			if( i < letteredOptions )
+			{
+				schema.add< bool >( option_name( i ), "A switch.", option_letter( i ));
+			}
+			else
+			{
+				schema.add< int >( option_name( i ), "A number." );
+			}
+		}
+	}
+
+	// The argv shapes to parse. Each is a plausible command line for a schema of optionCount options.
+	//
+	command_line_text short_cluster_argv( size_t optionCount )
+	{
+		std::vector< std::string > args{ "bench" };
+		const size_t letters = std::min( optionCount, letteredOptions );
+		for( size_t i = 0; i < 4; ++i )
+		{
+			std::string cluster = "-";
+			for( size_t j = 0; j < letters; j += 2 )
+			{
+				cluster += option_letter(( j + i ) % letters );
+			}
+			args.push_back( cluster );
+		}
+		return command_line_text{ std::move( args ) };
+	}
+
+	command_line_text long_form_argv( size_t optionCount )
+	{
+		std::vector< std::string > args{ "bench" };
+		for( size_t i = 0; i < 16; ++i )
+		{
+			const size_t option = letteredOptions + ( i * 7919 ) % ( optionCount - letteredOptions );
+			args.push_back( "--" + option_name( option ) + "=" + std::to_string( i * 1000 ));
+		}
+		return command_line_text{ std::move( args ) };
+	}
+
+	command_line_text unlabeled_argv( size_t )
+	{
+		std::vector< std::string > args{ "bench", "-a", "--option-1" };
+		for( size_t i = 0; i < 64; ++i )
+		{
+			args.push_back( "/data/project/inputs/file-" + std::to_string( i ) + ".dat" );
+		}
+		return command_line_text{ std::move( args ) };
+	}
+
+	struct shape
+	{
+		const char* name;
+		command_line_text ( *make )( size_t );
+	};
+
+	const shape shapes[] = {
+		{ "short-cluster", short_cluster_argv },
+		{ "long-form", long_form_argv },
+		{ "unlabeled", unlabeled_argv },
+	};
+
+	const size_t schemaSizes[] = { 10 + letteredOptions, 100, 1000, 10000 };
+
+	void bench_parse( report& out )
+	{
+		for( const size_t optionCount : schemaSizes )
+		{
+			arrrgh::parser parser( "bench", "Benchmark." );
+			add_options( parser, optionCount );
+
+			arrrgh::schema schema( "bench", "Benchmark." );
+			add_options( schema, optionCount );
+
+			for( const auto& shape : shapes )
+			{
+				const auto commandLine = shape.make( optionCount );
+				const double tokens = commandLine.argc() - 1;
+
+				const double parseNs = time_per_call( [&]()
+													 {
+														 parser.clear_values();
+														 parser.parse( commandLine.argc(), commandLine.argv.data() );
+													 } );
+				out.add( "parse", std::string( shape.name ) + " lines/sec", optionCount, 1e9 / parseNs, "lines/s" );
+				out.add( "parse", std::string( shape.name ) + " ns/token", optionCount, parseNs / tokens, "ns" );
+
+				const double borrowNs = time_per_call( [&]()
+													  {
+														  parser.clear_values();
+														  parser.parse( commandLine.argc(), commandLine.argv.data(), arrrgh::Borrow );
+													  } );
+				out.add( "parse-borrow", std::string( shape.name ) + " ns/token", optionCount, borrowNs / tokens, "ns" );
+
+				const double schemaNs = time_per_call( [&]()
+													  {
+														  do_not_optimize( schema.parse( commandLine.argc(), commandLine.argv.data() ));
+													  } );
+				out.add( "schema-parse", std::string( shape.name ) + " ns/token", optionCount, schemaNs / tokens, "ns" );
+			}
+		}
+	}
+
+	void bench_clear_values( report& out )
+	{
+		for( const size_t optionCount : schemaSizes )
+		{
+			arrrgh::parser parser( "bench", "Benchmark." );
+			add_options( parser, optionCount );
+
+			const auto commandLine = long_form_argv( optionCount );
+			parser.parse( commandLine.argc(), commandLine.argv.data() );
+
+			out.add( "clear_values", "after long-form parse", optionCount,
+					 time_per_call( [&]() { parser.clear_values(); } ), "ns" );
+		}
+	}
+
+	template< typename ValueT >
+	void bench_value_access( report& out, const char* typeName, const char* valueText )
+	{
+		arrrgh::parser parser( "bench", "Benchmark." );
+		const auto& arg = parser.add< ValueT >( "value", "A value." );
+
+		const std::string assignment = std::string( "--value=" ) + valueText;
+		const char* argv[] = { "bench", assignment.c_str() };
+		parser.parse( 2, argv );
+
+		constexpr int reads = 1000;
+		const double ns = time_per_call( [&]()
+										{
+											for( int i = 0; i < reads; ++i )
+											{
+												do_not_optimize( arg.value() );
+											}
+										} );
+		out.add( "value", typeName, 1, ns / reads, "ns" );
+	}
+
+	// Converting one value as arguments do (type_traits< ValueT >::parse()), against the istringstream extraction
+	// that it replaced. The inputs are distinct, so that nothing is predicted or cached across calls.
+	//
+	template< typename ValueT >
+	void bench_conversion( report& out, const char* typeName, std::string ( *element )( size_t ))
+	{
+		constexpr size_t inputCount = 100000;
+		
+		std::vector< std::string > inputs;
+		for( size_t i = 0; i < inputCount; ++i )
+		{
+			inputs.push_back( element( i ));
+		}
+		
+		size_t next = 0;
+		ValueT value{};
+		const double traitsNs = time_per_call( [&]()
+											  {
+												  const std::string& text = inputs[ next++ % inputCount ];
+												  arrrgh::type_traits< ValueT >::parse( text.data(), text.data() + text.size(), value );
+												  do_not_optimize( value );
+											  } );
+		const double streamNs = time_per_call( [&]()
+											  {
+												  std::istringstream stream( inputs[ next++ % inputCount ] );
+												  stream >> std::boolalpha >> value;
+												  do_not_optimize( value );
+											  } );
+		
+		out.add( "conversion", std::string( typeName ) + " type_traits parse", 1, traitsNs, "ns" );
+		out.add( "conversion", std::string( typeName ) + " istringstream", 1, streamNs, "ns" );
+	}
+	
+	// A list of numbers parsed by a std::vector argument, against splitting a string argument and converting each
+	// element with std::istringstream.
+	//
+	template< typename ValueT >
+	void bench_number_list( report& out, const char* typeName, std::string ( *element )( size_t ))
+	{
+		constexpr size_t elements = 10000;
+		
+		std::string list;
+		for( size_t i = 0; i < elements; ++i )
+		{
+			list += ( i ? "," : "" ) + element( i );
+		}
+		const std::string assignment = "--list=" + list;
+		const char* argv[] = { "bench", assignment.c_str() };
+		
+		arrrgh::parser listParser( "bench", "Benchmark." );
+		auto& listArg = listParser.add< std::vector< ValueT >>( "list", "A list." );
+		listArg.reserve( elements );
+		
+		const double listNs = time_per_call( [&]()
+											{
+												listParser.clear_values();
+												listParser.parse( 2, argv, arrrgh::Borrow );
+												do_not_optimize( listArg.values().data() );
+											} );
+		out.add( "number-list", std::string( typeName ) + " vector argument ns/element", elements, listNs / elements, "ns" );
+		
+		arrrgh::parser stringParser( "bench", "Benchmark." );
+		const auto& stringArg = stringParser.add< std::string >( "list", "A list." );
+		std::vector< ValueT > values;
+		values.reserve( elements );
+		
+		const double streamNs = time_per_call( [&]()
+											  {
+												  stringParser.clear_values();
+												  stringParser.parse( 2, argv, arrrgh::Borrow );
+												  
+												  values.clear();
+												  std::istringstream stream( stringArg.value() );
+												  std::string text;
+												  while( std::getline( stream, text, ',' ))
+												  {
+													  std::istringstream elementStream( text );
+													  ValueT value;
+													  elementStream >> value;
+													  values.push_back( value );
+												  }
+												  do_not_optimize( values.data() );
+											  } );
+		out.add( "number-list", std::string( typeName ) + " istringstream ns/element", elements, streamNs / elements, "ns" );
+		out.add( "number-list", std::string( typeName ) + " speedup", elements, streamNs / listNs, "x" );
+	}
+	
+	std::string int_element( size_t i )
+	{
+		return std::to_string(( i * 7919 ) % 1000003 );
+	}
+	
+	std::string float_element( size_t i )
+	{
+		return std::to_string( static_cast< double >(( i * 7919 ) % 1000003 ) / 1000.0 );
+	}
+	
+	std::string bool_element( size_t i )
+	{
+		return ( i * 7919 ) % 3 ? "true" : "false";
+	}
+	
+	// Answering a completion query: the first one after the options are added builds the trie of long forms.
+	//
+	void bench_completion( report& out )
+	{
+		for( const size_t optionCount : schemaSizes )
+		{
+			const char* argv[] = { "bench", "--arrrgh-complete", "bench", "--option-12", "bench" };
+			std::ostringstream completions;
+			
+			const double first = time_per_call( [&]()
+												{
+													arrrgh::parser parser( "bench", "Completion." );
+													add_options( parser, optionCount );
+													parser.complete( 5, argv, completions );
+													completions.str( {} );
+												} ) -
+								 time_per_call( [&]()
+												{
+													arrrgh::parser parser( "bench", "Completion." );
+													add_options( parser, optionCount );
+												} );
+			
+			arrrgh::parser parser( "bench", "Completion." );
+			add_options( parser, optionCount );
+			const double query = time_per_call( [&]()
+												{
+													parser.complete( 5, argv, completions );
+													completions.str( {} );
+												} );
+			
+			out.add( "completion", "first query, with trie build", optionCount, first / 1000, "us" );
+			out.add( "completion", "later query", optionCount, query / 1000, "us" );
+		}
+	}
+	
+	// The textbook dynamic-programming edit distance, as a baseline for suggestions.
+	//
+	size_t levenshtein( std::string_view a, std::string_view b, std::vector< size_t >& row )
+	{
+		row.resize( b.size() + 1 );
+		for( size_t j = 0; j <= b.size(); ++j )
+		{
+			row[ j ] = j;
+		}
+		for( size_t i = 1; i <= a.size(); ++i )
+		{
+			size_t diagonal = row[ 0 ];
+			row[ 0 ] = i;
+			for( size_t j = 1; j <= b.size(); ++j )
+			{
+				const size_t above = row[ j ];
+				row[ j ] = std::min( { row[ j ] + 1, row[ j - 1 ] + 1, diagonal + ( a[ i - 1 ] != b[ j - 1 ] ) } );
+				diagonal = above;
+			}
+		}
+		return row.back();
+	}
+	
+	// Failing on a misspelled option, with "did you mean" suggestions found three ways: the parser's walk of its
+	// trie, the shared schema's scan of every name (both bit-parallel), and the textbook distance to every name.
+	//
+	void bench_suggestions( report& out )
+	{
+		for( const size_t optionCount : schemaSizes )
+		{
+			std::string misspelled = option_name( optionCount - 7 );
+			std::swap( misspelled[ 3 ], misspelled[ 4 ] );		// "optoin-..."
+			const std::string arg = "--" + misspelled + "=3";
+			const char* argv[] = { "bench", arg.c_str() };
+			
+			arrrgh::parser parser( "bench", "Suggestions." );
+			add_options( parser, optionCount );
+			
+			std::string message;
+			const double trie = time_per_call( [&]()
+											   {
+												   parser.clear_values();
+												   const arrrgh::parse_status status = parser.try_parse( 2, argv );
+												   message = parser.error_message( status );
+											   } );
+			
+			arrrgh::schema schema( "bench", "Suggestions." );
+			add_options( schema, optionCount );
+			const double scan = time_per_call( [&]()
+											   {
+												   try
+												   {
+													   schema.parse( 2, argv );
+												   }
+												   catch( const std::exception& e )
+												   {
+													   message = e.what();
+												   }
+											   } );
+			
+			std::vector< std::string > names;
+			for( size_t i = 0; i < optionCount; ++i )
+			{
+				names.push_back( option_name( i ));
+			}
+			
+			std::vector< size_t > row;
+			const double naive = time_per_call( [&]()
+												{
+													size_t best = SIZE_MAX;
+													const std::string* nearest = nullptr;
+													for( const auto& name : names )
+													{
+														const size_t distance = levenshtein( misspelled, name, row );
+														if( distance < best )
+														{
+															best = distance;
+															nearest = &name;
+														}
+													}
+													do_not_optimize( nearest );
+												} );
+			
+			out.add( "suggestions", "parser, trie walk, bit-parallel", optionCount, trie / 1000, "us" );
+			out.add( "suggestions", "schema, scan, bit-parallel", optionCount, scan / 1000, "us" );
+			out.add( "suggestions", "scan, textbook distance", optionCount, naive / 1000, "us" );
+		}
+	}
+	
+	// A worker taking its supervisor's values: parsing the long-form command line again, against loading what
+	// saved_values() saved from parsing it once.
+	//
+	void bench_saved_values( report& out )
+	{
+		for( const size_t optionCount : schemaSizes )
+		{
+			arrrgh::parser parser( "bench", "Saved values." );
+			add_options( parser, optionCount );
+			
+			const auto commandLine = long_form_argv( optionCount );
+			parser.parse( commandLine.argc(), commandLine.argv.data() );
+			const std::string saved = parser.saved_values();
+			
+			const double parse = time_per_call( [&]()
+												{
+													parser.clear_values();
+													parser.parse( commandLine.argc(), commandLine.argv.data(), arrrgh::Borrow );
+												} );
+			const double load = time_per_call( [&]()
+											   {
+												   parser.clear_values();
+												   parser.load_values( saved, arrrgh::Borrow );
+											   } );
+			
+			out.add( "saved values", "parse command line", optionCount, parse / 1000, "us" );
+			out.add( "saved values", "load saved values", optionCount, load / 1000, "us" );
+			out.add( "saved values", "size", optionCount, saved.size(), "bytes" );
+		}
+	}
+	
+#if HAVE_POSIX
+	// getopt_long over the same inputs, for comparison. Its options are found by a linear search.
+	//
+	void bench_getopt( report& out )
+	{
+		for( const size_t optionCount : schemaSizes )
+		{
+			std::vector< std::string > names;
+			for( size_t i = 0; i < optionCount; ++i )
+			{
+				names.push_back( option_name( i ));
+			}
+
+			std::vector< option > options;
+			std::string letters;
+			for( size_t i = 0; i < optionCount; ++i )
+			{
+				const bool lettered = i < letteredOptions;
+				options.push_back( { names[ i ].c_str(), lettered ? no_argument : required_argument, nullptr,
+									 lettered ? option_letter( i ) : static_cast< int >( 256 + i ) } );
+				if( lettered )
+				{
+					letters += option_letter( i );
+				}
+			}
+			options.push_back( { nullptr, 0, nullptr, 0 } );
+
+			for( const auto& shape : shapes )
+			{
+				auto commandLine = shape.make( optionCount );
+
+				// getopt_long permutes argv, so give it a fresh copy each time.
+				//
+				std::vector< char* > argv( commandLine.argv.size() );
+
+				const double ns = time_per_call( [&]()
+												{
+													for( size_t i = 0; i < argv.size(); ++i )
+													{
+														argv[ i ] = const_cast< char* >( commandLine.argv[ i ] );
+													}
+
+													optind = 0;		// Restart scanning (GNU); harmless elsewhere.
+													opterr = 0;
+
+													int sum = 0;
+													int index = 0;
+													int c;
+													while(( c = getopt_long( commandLine.argc(), argv.data(), letters.c_str(),
+																			 options.data(), &index )) != -1 )
+													{
+														sum += c;
+														if( optarg )
+														{
+															sum += std::atoi( optarg );
+														}
+													}
+													do_not_optimize( sum );
+												} );
+				out.add( "getopt_long", std::string( shape.name ) + " ns/token", optionCount, ns / ( commandLine.argc() - 1 ), "ns" );
+			}
+		}
+	}
+
+	// Spawns this program in one of its startup modes (see main()) and waits for it. Returns the average
+	// microseconds per run, or a negative number if a run couldn't be spawned or didn't exit cleanly.
+	//
+	double spawn_startup( const char* self, const char* mode )
+	{
+		constexpr int runs = 100;
+
+		const auto start = clock_type::now();
+		for( int i = 0; i < runs; ++i )
+		{
+			const char* argv[] = { self, mode, "-abc", "--option-3", "--option-40=7", "input.dat", nullptr };
+			pid_t pid;
+			int status;
+			if( posix_spawnp( &pid, self, nullptr, nullptr, const_cast< char** >( argv ), environ ) != 0 ||
+				waitpid( pid, &status, 0 ) != pid ||
+				!WIFEXITED( status ) || WEXITSTATUS( status ) != 0 )
+			{
+				return -1;
+			}
+		}
+		return std::chrono::duration< double, std::micro >( clock_type::now() - start ).count() / runs;
+	}
+
+	// self is argv[ 0 ], which posix_spawnp() looks up on the PATH if it has no '/'. Linux names the running
+	// executable exactly.
+	//
+	void bench_startup( report& out, const char* self )
+	{
+#if defined( __linux__ )
+		self = "/proc/self/exe";
+#endif
+		const double empty = spawn_startup( self, "--startup-empty" );
+		const double tool = spawn_startup( self, "--startup-tool" );
+		const double completion = spawn_startup( self, "--arrrgh-complete" );
+		
+		if( empty < 0 || tool < 0 || completion < 0 )
+		{
+			std::cerr << "startup: could not run " << self << "; no startup times recorded." << std::endl;
+			return;
+		}
+
+		out.add( "startup", "exec to exit, empty main", 0, empty, "us" );
+		out.add( "startup", "exec to exit, minimal tool", 50, tool, "us" );
+		out.add( "startup", "minimal tool over empty main", 50, tool - empty, "us" );
+		out.add( "startup", "exec to exit, completion query", 1000, completion, "us" );
+		out.add( "startup", "completion query over empty main", 1000, completion - empty, "us" );
+	}
+#endif
+
+	// What the spawned "minimal tool" does: set up a parser with a typical number of options, parse, and exit.
+	//
+	int startup_tool( int argc, const char* argv[] )
+	{
+		arrrgh::parser parser( "bench", "A minimal tool." );
+		add_options( parser, 50 );
+		parser.add< bool >( "startup-tool", "How we were started." );
+		parser.parse( argc, argv );
+		return 0;
+	}
+
+	// What the spawned completion query does: set up a large parser and answer for "--option-3" (argv[ 3 ]).
+	//
+	int completion_tool( int argc, const char* argv[] )
+	{
+		arrrgh::parser parser( "bench", "A tool with many options." );
+		add_options( parser, 1000 );
+
+		std::ofstream devNull( "/dev/null" );
+		return parser.complete( argc, argv, devNull ) ? 0 : 1;
+	}
+}
+
+int main( int argc, const char* argv[] )
+{
+	if( argc > 1 && std::string( argv[ 1 ] ) == "--startup-empty" )
+	{
+		return 0;
+	}
+	if( argc > 1 && std::string( argv[ 1 ] ) == "--startup-tool" )
+	{
+		return startup_tool( argc, argv );
+	}
+	if( argc > 1 && std::string( argv[ 1 ] ) == "--arrrgh-complete" )
+	{
+		return completion_tool( argc, argv );
+	}
+
+	report out( "bench_output.txt" );
+
+	bench_parse( out );
+	bench_clear_values( out );
+
+	bench_value_access< int >( out, "int", "42" );
+	bench_value_access< double >( out, "double", "2.5" );
+	bench_value_access< bool >( out, "bool", "yes" );
+	bench_value_access< std::string >( out, "std::string", "a value long enough to need the heap" );
+	
+	bench_conversion< int >( out, "int", int_element );
+	bench_conversion< double >( out, "double", float_element );
+	bench_conversion< bool >( out, "bool", bool_element );
+	
+	bench_number_list< int >( out, "int", int_element );
+	bench_number_list< double >( out, "double", float_element );
+	
+	bench_completion( out );
+	bench_suggestions( out );
+	bench_saved_values( out );
+
+#if HAVE_POSIX
+	bench_getopt( out );
+	bench_startup( out, argv[ 0 ] );
+#endif
+
+	return 0;
+}
@@ -6,8 +6,39 @@
 //
 
 #include "arrrgh.hpp"
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
 
+// Count every global allocation so tests can check that steady-state parsing doesn't allocate.
+//
+namespace
+{
+	std::atomic< size_t > allocationCount{ 0 };
+}
+
+void* operator new( size_t size )
+{
+	++allocationCount;
+	if( void* p = std::malloc( size ? size : 1 ))
+	{
+		return p;
+	}
+	throw std::bad_alloc{};
+}
+
+// Out of line, so that the compiler doesn't pair this free() with operator new and warn about the mismatch.
+//
+[[gnu::noinline]] void operator delete( void* p ) noexcept
+{
+	std::free( p );
+}
+
+[[gnu::noinline]] void operator delete( void* p, size_t ) noexcept
+{
+	std::free( p );
+}
+
 namespace
 {
 	const bool VERBOSE = true;
@@ -22,7 +53,7 @@ namespace
 		const std::string& name() const { return m_name; }
 		arrrgh::parser& parser() { return m_parser; }
 		
-		bool test( int argc, const char* argv[], bool expectFailure )
+		bool test( int argc, const char* const argv[], bool expectFailure )
 		{
 			m_parser.clear_values();
 						
@@ -86,77 +117,18 @@ namespace
 				std::cout << "Testing " << m_name << ": '" << commandLine << "' expecting " << ( expectFailure ? "failure" : "success" ) << "..." << std::endl;
 			}
 			
-			// Prepend program name.
-			
-			commandLine = m_name + " " + commandLine;
-			
-			// Break command line into arguments.
-						
-			const char* const rawCommandLine = commandLine.c_str();
-			const char* const endCommandLine = rawCommandLine + commandLine.size();
-			
-			std::vector< std::string > args;
-
-			bool quoted = false;
-			bool skippingSpace = false;
-			
-			const char* tokenStart = rawCommandLine;
-			for( const char* pc = tokenStart; pc != endCommandLine; ++pc )
-			{
-				const char c = *pc;
-				
-				if( !quoted && std::isspace( c ))
-				{
-					if( !skippingSpace )
-					{
-						// Here endeth a token. Copy it.
-						//
-						std::string arg;
-						std::copy( tokenStart, pc, std::back_inserter( arg ));
-						
-						args.emplace_back( std::move( arg ));
-					}
-					
-					skippingSpace = true;
-				}
-				else
-				{
-					if( skippingSpace )
-					{
-						// Start of new token.
-						//
-						tokenStart = pc;
-					}
-					skippingSpace = false;
-					
-					if( c == '\"' )
-					{
-						quoted = !quoted;
-					}
-				}
-			}
-			
-			if( !skippingSpace )
-			{
-				// Copy the last token.
-				//
-				std::string arg;
-				std::copy( tokenStart, endCommandLine, std::back_inserter( arg ));
-				args.emplace_back( std::move( arg ));
-			}
-			
-			// Convert arg strings to array of pointers.
+			// Prepend program name and break the command line into arguments.
 			//
-			std::vector< const char* > rawArgs;
-			std::transform( args.begin(), args.end(), std::back_inserter( rawArgs ), []( const std::string& s ) { return s.c_str(); } );
+			const auto args = m_tokenizer.tokenize( m_name + " " + commandLine );
 			
-			return test( static_cast< int >( args.size() ), rawArgs.data(), expectFailure );
+			return test( args.argc, args.argv, expectFailure );
 		}
 		
 	private:
 		
 		std::string m_name;
 		arrrgh::parser m_parser;
+		arrrgh::tokenizer m_tokenizer;
 	};
 }
 
@@ -357,6 +329,18 @@ void testOptionalNumericArg()
 	{
 		if( VERBOSE ) std::cout << program.name() << " succeeded.\n";
 		VERIFY_EQUAL( arg.value(), 128 );
+		VERIFY_TEST( &arg.value() == &arg.value() );	// Cached, not reconverted.
+	}
+	
+	// EXPECT FAILURE: Value doesn't convert. Reported by parse().
+	//
+	if( !program.test( "--weight=heavy", true ))
+	{
+		std::cout << program.name() << " FAILED" << std::endl;
+	}
+	else
+	{
+		if( VERBOSE ) std::cout << program.name() << " succeeded.\n";
 	}
 }
 
@@ -422,9 +406,9 @@ void testEverything( bool withEqualSign )
 		VERIFY_EQUAL( argG.value(), 16.25f );
 		VERIFY_EQUAL( argH.value(), 8 );
 		
-		// Note: The command line processor (e.g. bash) actually
-		// removes the quotes, but we're too lazy to do that in our command line tokenizer.
-		VERIFY_EQUAL( argS.value(), "\"Absolom, Absolom\"" );
+		// The tokenizer removes the quotes, as a shell would.
+		//
+		VERIFY_EQUAL( argS.value(), "Absolom, Absolom" );
 		
 		std::string argString;
 		program.parser().each_unlabeled_argument( [&]( const std::string& arg )
@@ -439,6 +423,1863 @@ void testEverything( bool withEqualSign )
 	}
 }
 
+void testManyArgs()
+{
+	program program( "many_args", "Tests lookup in a large set of arguments." );
+	
+	std::vector< const arrrgh::argument< int >* > args;
+	for( int i = 0; i < 200; ++i )
+	{
+		args.push_back( &program.parser().add< int >( "option-" + std::to_string( i ), "Numbered option." ));
+	}
+	
+	const auto& argX = program.parser().add< bool >( "", "x.", 'x' );
+	const auto& argY = program.parser().add< bool >( "", "y.", 'y' );
+	
+	VERIFY_TEST( program.parser().has_long_form_argument( "option-199" ));
+	VERIFY_TEST( !program.parser().has_long_form_argument( "option-200" ));
+	VERIFY_TEST( !program.parser().has_long_form_argument( "" ));
+	VERIFY_TEST( program.parser().has_letter_argument( 'x' ));
+	VERIFY_TEST( !program.parser().has_letter_argument( 'z' ));
+	VERIFY_TEST( !program.parser().has_letter_argument( '\0' ));
+	
+	// EXPECT SUCCESS: A few of the many arguments passed in.
+	//
+	if( !program.test( "--option-0=1 --option-123=123 -xy --option-199=-4", false ))
+	{
+		std::cout << program.name() << " FAILED" << std::endl;
+	}
+	else
+	{
+		if( VERBOSE ) std::cout << program.name() << " succeeded.\n";
+		VERIFY_EQUAL( args[ 0 ]->value(), 1 );
+		VERIFY_EQUAL( args[ 1 ]->value(), 0 );
+		VERIFY_EQUAL( args[ 123 ]->value(), 123 );
+		VERIFY_EQUAL( args[ 199 ]->value(), -4 );
+		VERIFY_TEST( argX.value() );
+		VERIFY_TEST( argY.value() );
+	}
+	
+	// EXPECT FAILURE: Unknown long form and letter.
+	//
+	if( !program.test( "--option-200=1", true ))
+	{
+		std::cout << program.name() << " FAILED" << std::endl;
+	}
+	else
+	{
+		if( VERBOSE ) std::cout << program.name() << " succeeded.\n";
+	}
+	
+	if( !program.test( "-xz", true ))
+	{
+		std::cout << program.name() << " FAILED" << std::endl;
+	}
+	else
+	{
+		if( VERBOSE ) std::cout << program.name() << " succeeded.\n";
+	}
+}
+
+namespace
+{
+	constexpr arrrgh::option< bool > staticFast{ "fast", "Should this program run fast?", 'f' };
+	constexpr arrrgh::option< bool > staticOdd{ "", "No long-form argument for this one.", 'o' };
+	constexpr arrrgh::option< float > staticMass{ "mass", "The mass of the thing.", 'm', arrrgh::Optional, 3.141f };
+	constexpr arrrgh::option< int > staticHeight{ "height", "The height of the thing.", '\0', arrrgh::Required };
+	constexpr arrrgh::option< std::string > staticName{ "name", "The name of the wind.", 's', arrrgh::Optional, "wind" };
+}
+
+void testStaticParser()
+{
+	arrrgh::static_parser< staticFast, staticOdd, staticMass, staticHeight, staticName > parser( "static", "Tests static_parser." );
+	
+	// EXPECT SUCCESS: A mix of forms and unlabeled arguments.
+	//
+	const char* argv[] = { "static", "-fo", "--height=8", "unlabeled", "--name=Absolom", "--", "--weirdly-unlabeled" };
+	
+	try
+	{
+		parser.parse( 7, argv );
+		
+		VERIFY_TEST( parser.value< staticFast >() );
+		VERIFY_TEST( parser.value< staticOdd >() );
+		VERIFY_TEST( !parser.assigned< staticMass >() );
+		VERIFY_EQUAL( parser.value< staticMass >(), 3.141f );
+		VERIFY_EQUAL( parser.value< staticHeight >(), 8 );
+		VERIFY_EQUAL( parser.value< staticName >(), "Absolom" );
+		
+		std::string argString;
+		parser.each_unlabeled_argument( [&]( std::string_view arg )
+									   {
+										   argString += arg;
+										   argString += " ";
+									   } );
+		argString.pop_back();	// Final space.
+		
+		VERIFY_EQUAL( argString, "unlabeled --weirdly-unlabeled" );
+	}
+	catch( const std::exception& e )
+	{
+		std::cout << "Test failed: static_parser threw " << e.what() << std::endl;
+	}
+	
+	// EXPECT FAILURE: Missing required, unknown argument, bad value.
+	//
+	const char* missing[] = { "static", "-f" };
+	const char* unknown[] = { "static", "--height=1", "-x" };
+	const char* badValue[] = { "static", "--height=tall" };
+	
+	for( const auto& args : { std::make_pair( 2, missing ), std::make_pair( 3, unknown ), std::make_pair( 2, badValue ) } )
+	{
+		parser.clear_values();
+		
+		try
+		{
+			parser.parse( args.first, args.second );
+			std::cout << "Test failed: static_parser failed to fail." << std::endl;
+		}
+		catch( const std::exception& e )
+		{
+			if( VERBOSE ) std::cerr << "Error parsing arguments: " << e.what() << std::endl;
+		}
+	}
+	
+	parser.clear_values();
+	VERIFY_TEST( !parser.value< staticFast >() );
+	VERIFY_EQUAL( parser.value< staticName >(), "wind" );
+}
+
+namespace
+{
+	struct extent
+	{
+		int width = 0;
+		int height = 0;
+		
+		bool operator==( const extent& other ) const { return width == other.width && height == other.height; }
+	};
+	
+	std::ostream& operator<<( std::ostream& out, const extent& e )
+	{
+		return out << e.width << "x" << e.height;
+	}
+}
+
+namespace arrrgh
+{
+	template<>
+	struct type_traits< extent >
+	{
+		static constexpr bool always_requires_value() { return true; }
+		static constexpr const char* name() { return "WxH"; }
+		
+		static bool parse( const char* first, const char* last, extent& result )
+		{
+			const char* separator = std::find( first, last, 'x' );
+			return separator != last
+				&& type_traits< int >::parse( first, separator, result.width )
+				&& type_traits< int >::parse( separator + 1, last, result.height );
+		}
+	};
+}
+
+void testConversions()
+{
+	program program( "conversions", "Tests conversion of assorted value types." );
+	
+	const auto& argByte = program.parser().add< short >( "byte", "b." );
+	const auto& argShort = program.parser().add< unsigned short >( "short", "s." );
+	const auto& argLong = program.parser().add< long long >( "long", "l." );
+	const auto& argULong = program.parser().add< unsigned long long >( "ulong", "u." );
+	const auto& argDouble = program.parser().add< double >( "double", "d." );
+	const auto& argBool = program.parser().add< bool >( "bool", "B.", 'B', arrrgh::Optional, true );
+	const auto& argExtent = program.parser().add< extent >( "extent", "e." );
+	
+	// EXPECT SUCCESS: Every type given a value.
+	//
+	if( !program.test( "--byte=-30000 --short=65535 --long=-9000000000 --ulong=18446744073709551615 --double=+2.5e3 --bool=no --extent=640x480", false ))
+	{
+		std::cout << program.name() << " FAILED" << std::endl;
+	}
+	else
+	{
+		if( VERBOSE ) std::cout << program.name() << " succeeded.\n";
+		VERIFY_EQUAL( argByte.value(), -30000 );
+		VERIFY_EQUAL( argShort.value(), 65535 );
+		VERIFY_EQUAL( argLong.value(), -9000000000ll );
+		VERIFY_EQUAL( argULong.value(), 18446744073709551615ull );
+		VERIFY_EQUAL( argDouble.value(), 2500.0 );
+		VERIFY_TEST( !argBool.value() );
+		VERIFY_EQUAL( argExtent.value(), ( extent{ 640, 480 } ));
+	}
+	
+	// EXPECT SUCCESS: Bool switch present with no value.
+	//
+	if( !program.test( "-B", false ))
+	{
+		std::cout << program.name() << " FAILED" << std::endl;
+	}
+	else
+	{
+		if( VERBOSE ) std::cout << program.name() << " succeeded.\n";
+		VERIFY_TEST( argBool.value() );
+	}
+	
+	// EXPECT FAILURE: Out of range, not a bool, malformed custom type.
+	//
+	for( const char* commandLine : { "--byte=40000", "--bool=purple", "--extent=640" } )
+	{
+		if( !program.test( commandLine, true ))
+		{
+			std::cout << program.name() << " FAILED" << std::endl;
+		}
+		else
+		{
+			if( VERBOSE ) std::cout << program.name() << " succeeded.\n";
+		}
+	}
+}
+
+void testArgumentOwnership()
+{
+	arrrgh::parser parser( "ownership", "Tests copied and borrowed argument text." );
+	
+	const auto& argName = parser.add< std::string >( "name", "n.", 'n' );
+	const auto& argCount = parser.add< int >( "count", "c.", 'c' );
+	
+	// Copied: values survive the argument strings.
+	//
+	{
+		std::vector< std::string > args{ "ownership", "--name=a name long enough to need the heap", "-c=3", "unlabeled" };
+		std::vector< const char* > argv;
+		for( const auto& arg : args ) argv.push_back( arg.c_str() );
+		
+		parser.parse( static_cast< int >( argv.size() ), argv.data() );
+		
+		args.clear();
+	}
+	
+	VERIFY_EQUAL( argName.value(), "a name long enough to need the heap" );
+	VERIFY_EQUAL( argName.value_view(), "a name long enough to need the heap" );
+	VERIFY_EQUAL( argCount.value(), 3 );
+	
+	// Borrowed: values and unlabeled arguments are views into argv.
+	//
+	parser.clear_values();
+	
+	const char* argv[] = { "ownership", "-n=borrowed", "unlabeled", "--", "-c=4" };
+	parser.parse( 5, argv, arrrgh::Borrow );
+	
+	VERIFY_TEST( argName.value_view().data() == argv[ 1 ] + 3 );
+	VERIFY_TEST( !argCount.assigned() );
+	
+	// value() only reads, so threads may share it.
+	//
+	std::vector< std::thread > readers;
+	for( int i = 0; i < 2; ++i )
+	{
+		readers.emplace_back( [&]() { VERIFY_EQUAL( argName.value(), "borrowed" ); } );
+	}
+	for( auto& reader : readers )
+	{
+		reader.join();
+	}
+	
+	std::vector< std::string_view > unlabeled;
+	parser.each_unlabeled_argument_view( [&]( std::string_view arg ) { unlabeled.push_back( arg ); } );
+	
+	VERIFY_EQUAL( unlabeled.size(), 2u );
+	VERIFY_TEST( unlabeled[ 0 ].data() == argv[ 2 ] );
+	VERIFY_TEST( unlabeled[ 1 ].data() == argv[ 4 ] );
+}
+
+namespace
+{
+	class counting_resource : public std::pmr::memory_resource
+	{
+	public:
+		explicit counting_resource( std::pmr::memory_resource* upstream ) : m_upstream( upstream ) {}
+		
+		size_t allocations() const { return m_allocations; }
+		size_t outstanding() const { return m_outstanding; }
+		
+		// Makes allocation number count (from 1) throw std::bad_alloc.
+		//
+		void fail_at( size_t count ) { m_failAt = count; }
+		
+	private:
+		std::pmr::memory_resource* m_upstream;
+		size_t m_allocations = 0;
+		size_t m_outstanding = 0;
+		size_t m_failAt = 0;
+		
+		virtual void* do_allocate( size_t bytes, size_t alignment ) override
+		{
+			if( ++m_allocations == m_failAt )
+			{
+				throw std::bad_alloc{};
+			}
+			++m_outstanding;
+			return m_upstream->allocate( bytes, alignment );
+		}
+		
+		virtual void do_deallocate( void* p, size_t bytes, size_t alignment ) override
+		{
+			--m_outstanding;
+			m_upstream->deallocate( p, bytes, alignment );
+		}
+		
+		virtual bool do_is_equal( const std::pmr::memory_resource& other ) const noexcept override
+		{
+			return this == &other;
+		}
+	};
+}
+
+void testAddFailure()
+{
+	// Whichever allocation add() fails at, destroying the schema returns everything.
+	//
+	for( size_t failAt = 1; ; ++failAt )
+	{
+		counting_resource resource{ std::pmr::new_delete_resource() };
+		bool added = false;
+		{
+			arrrgh::schema schema( "failing", "Tests add() running out of memory.", &resource );
+			schema.add< int >( "a-long-enough-name-to-need-the-heap", "An explanation long enough to need the heap too." );
+			
+			resource.fail_at( resource.allocations() + failAt );
+			try
+			{
+				schema.add< std::string >( "another-name-long-enough-for-the-heap", "Another explanation long enough for the heap." );
+				added = true;
+			}
+			catch( const std::bad_alloc& )
+			{}
+		}
+		VERIFY_EQUAL( resource.outstanding(), 0u );
+		
+		if( added )
+		{
+			break;
+		}
+	}
+}
+
+void testSteadyStateAllocations()
+{
+	std::pmr::monotonic_buffer_resource arena;
+	counting_resource resource{ &arena };
+	
+	arrrgh::parser parser( "steady", "Tests that reused parsers stop allocating.", &resource );
+	
+	const auto& argName = parser.add< std::string >( "name", "n.", 'n' );
+	const auto& argCount = parser.add< int >( "count", "c.", 'c' );
+	parser.add< bool >( "", "v.", 'v' );
+	
+	const char* argv[] = { "steady", "--name=a name long enough to need the heap", "-v", "-c=12",
+						   "an unlabeled argument long enough to need the heap", "--", "-x" };
+	
+	VERIFY_TEST( resource.allocations() > 0 );
+	
+	for( const auto ownership : { arrrgh::Copy, arrrgh::Borrow } )
+	{
+		// Warm up.
+		//
+		for( int i = 0; i < 2; ++i )
+		{
+			parser.parse( 7, argv, ownership );
+			parser.clear_values();
+		}
+		
+		const size_t allocationsBefore = allocationCount;
+		const size_t resourceAllocationsBefore = resource.allocations();
+		
+		for( int i = 0; i < 1000; ++i )
+		{
+			parser.parse( 7, argv, ownership );
+			
+			if( i == 999 )
+			{
+				VERIFY_EQUAL( argName.value(), "a name long enough to need the heap" );
+				VERIFY_EQUAL( argCount.value(), 12 );
+			}
+			
+			parser.clear_values();
+		}
+		
+		VERIFY_EQUAL( allocationCount - allocationsBefore, 0u );
+		VERIFY_EQUAL( resource.allocations() - resourceAllocationsBefore, 0u );
+	}
+}
+
+void testBatch()
+{
+	arrrgh::parser parser( "batch", "Tests parsing many command lines at once." );
+	
+	const auto& argCount = parser.add< int >( "count", "c.", 'c', arrrgh::Required );
+	const auto& argName = parser.add< std::string >( "name", "n.", 'n', arrrgh::Optional, "nobody" );
+	const auto& argFast = parser.add< bool >( "fast", "f.", 'f' );
+	
+	// Lots of command lines, every seventh of which is missing its required argument.
+	//
+	std::vector< std::vector< std::string >> args;
+	for( int i = 0; i < 1000; ++i )
+	{
+		args.push_back( { "batch", "--name=a name long enough to need the heap " + std::to_string( i ), "unlabeled", std::to_string( i ) } );
+		if( i % 7 != 0 )
+		{
+			args.back().push_back( "-fc=" + std::to_string( i ));
+		}
+	}
+	
+	std::vector< std::vector< const char* >> argvs;
+	std::vector< arrrgh::command_line > commandLines;
+	for( const auto& arg : args )
+	{
+		argvs.emplace_back();
+		for( const auto& s : arg ) argvs.back().push_back( s.c_str() );
+		commandLines.push_back( { static_cast< int >( argvs.back().size() ), argvs.back().data() } );
+	}
+	
+	for( unsigned int threadCount : { 1u, 4u } )
+	{
+		const auto result = parser.parse_batch( commandLines, threadCount );
+		
+		VERIFY_EQUAL( result.size(), commandLines.size() );
+		
+		for( size_t i = 0; i < result.size(); ++i )
+		{
+			const auto entry = result[ i ];
+			
+			if( i % 7 == 0 )
+			{
+				VERIFY_TEST( entry.error() );
+				VERIFY_TEST( !entry.assigned( argFast ));
+			}
+			else
+			{
+				VERIFY_TEST( !entry.error() );
+				VERIFY_EQUAL( entry.value( argCount ), static_cast< int >( i ));
+				VERIFY_TEST( entry.value( argFast ));
+			}
+			
+			VERIFY_EQUAL( entry.value( argName ), "a name long enough to need the heap " + std::to_string( i ));
+			VERIFY_EQUAL( entry.unlabeled_arguments().size(), 2u );
+			VERIFY_EQUAL( entry.unlabeled_arguments()[ 1 ], std::to_string( i ));
+		}
+	}
+	
+	// The arguments themselves are untouched.
+	//
+	VERIFY_TEST( !argCount.assigned() );
+	VERIFY_EQUAL( argName.value(), "nobody" );
+}
+
+void testSharedSchema()
+{
+	arrrgh::schema schema( "shared", "Tests parsing against one schema from several threads." );
+	
+	const auto& argCount = schema.add< int >( "count", "c.", 'c', arrrgh::Required );
+	const auto& argName = schema.add< std::string >( "name", "n.", 'n', arrrgh::Optional, "nobody" );
+	const auto& argFast = schema.add< bool >( "fast", "f.", 'f' );
+	
+	// Each thread parses its own command lines, with no locking.
+	//
+	std::atomic< int > failures{ 0 };
+	std::vector< std::thread > threads;
+	for( int t = 0; t < 4; ++t )
+	{
+		threads.emplace_back( [&, t]()
+		{
+			for( int i = 0; i < 200; ++i )
+			{
+				const std::string count = "--count=" + std::to_string( t * 1000 + i );
+				const std::string name = "--name=thread name long enough to need the heap " + std::to_string( t );
+				const char* argv[] = { "shared", count.c_str(), name.c_str(), "unlabeled" };
+				
+				const auto result = schema.parse( 4, argv );
+				
+				if( result.value( argCount ) != t * 1000 + i ||
+				    result.value( argName ) != "thread name long enough to need the heap " + std::to_string( t ) ||
+				    result.value( argFast ) ||
+				    result.unlabeled_arguments().size() != 1 ||
+				    result.help_requested() )
+				{
+					++failures;
+				}
+			}
+		} );
+	}
+	for( auto& thread : threads )
+	{
+		thread.join();
+	}
+	VERIFY_EQUAL( failures.load(), 0 );
+	
+	// Defaults, errors and help.
+	//
+	{
+		const char* argv[] = { "shared", "-fc=3" };
+		const auto result = schema.parse( 2, argv );
+		VERIFY_TEST( result.assigned( argCount ));
+		VERIFY_TEST( !result.assigned( argName ));
+		VERIFY_EQUAL( result.value( argName ), "nobody" );
+		VERIFY_TEST( result.value( argFast ));
+	}
+	{
+		const char* argv[] = { "shared", "--fast" };
+		try
+		{
+			schema.parse( 2, argv );
+			std::cout << "Test failed: schema failed to fail." << std::endl;
+		}
+		catch( const arrrgh::schema::MissingRequiredArguments& e )
+		{
+			if( VERBOSE ) std::cerr << "Error parsing arguments: " << e.what() << std::endl;
+		}
+	}
+	{
+		const char* argv[] = { "shared", "-h", "--count=1" };
+		VERIFY_TEST( schema.parse( 3, argv ).help_requested() );
+	}
+	
+	// The arguments themselves are untouched.
+	//
+	VERIFY_TEST( !argCount.assigned() );
+	VERIFY_EQUAL( argName.value(), "nobody" );
+}
+
+void testTokenizer()
+{
+	arrrgh::tokenizer tokenizer;
+	
+	const auto tokens = [&]( std::string_view commandLine )
+	{
+		const auto args = tokenizer.tokenize( commandLine );
+		
+		std::string joined;
+		for( int i = 0; i < args.argc; ++i )
+		{
+			joined += "[";
+			joined += args.argv[ i ];
+			joined += "]";
+		}
+		return joined;
+	};
+	
+	VERIFY_EQUAL( tokens( "" ), "" );
+	VERIFY_EQUAL( tokens( " \t\n " ), "" );
+	VERIFY_EQUAL( tokens( "prog  -a\t--b=c  d " ), "[prog][-a][--b=c][d]" );
+	VERIFY_EQUAL( tokens( "--name=\"Absolom, Absolom\" 'single \" quoted' mixed\"up\"'parts'" ),
+				  "[--name=Absolom, Absolom][single \" quoted][mixedupparts]" );
+	VERIFY_EQUAL( tokens( "a\\ b \\\"c \"\\\"\\x\\$\" '\\n' \"\" ''" ), "[a b][\"c][\"\\x$][\\n][][]" );
+	VERIFY_EQUAL( tokens( "line\\\ncontinued trailing\\" ), "[linecontinued][trailing\\]" );
+	
+	// Long enough for the vectorized scan, with specials on either side of 16-byte boundaries.
+	//
+	const std::string longArg( 37, 'x' );
+	VERIFY_EQUAL( tokens( longArg + "\t" + longArg + "\"" + longArg + " \"\r" + longArg ),
+				  "[" + longArg + "][" + longArg + longArg + " ][" + longArg + "]" );
+	
+	// EXPECT FAILURE: unterminated quotes.
+	//
+	for( const char* bad : { "a 'b", "a \"b\\\"", "\"" } )
+	{
+		try
+		{
+			tokenizer.tokenize( bad );
+			std::cout << "Test failed: tokenizer failed to fail on " << bad << std::endl;
+		}
+		catch( const arrrgh::tokenizer::UnterminatedQuote& e )
+		{
+			if( VERBOSE ) std::cerr << "Error tokenizing: " << e.what() << std::endl;
+		}
+	}
+	
+	// Tokenizing reuses its buffer.
+	//
+	const std::string commandLine = "prog --name=\"a name long enough to need the heap\" unlabeled -fc=3";
+	tokenizer.tokenize( commandLine );
+	
+	const size_t allocationsBefore = allocationCount;
+	for( int i = 0; i < 100; ++i )
+	{
+		tokenizer.tokenize( commandLine );
+	}
+	VERIFY_EQUAL( allocationCount - allocationsBefore, 0u );
+}
+
+void testResponseFiles()
+{
+	arrrgh::parser parser( "response", "Tests reading arguments from response files." );
+	parser.expand_response_files();
+	
+	const auto& argCount = parser.add< int >( "count", "c.", 'c', arrrgh::Required );
+	const auto& argName = parser.add< std::string >( "name", "n.", 'n' );
+	const auto& argFast = parser.add< bool >( "fast", "f.", 'f' );
+	
+	const auto writeFile = []( const char* path, const std::string& contents )
+	{
+		std::FILE* const file = std::fopen( path, "wb" );
+		std::fwrite( contents.data(), 1, contents.size(), file );
+		std::fclose( file );
+	};
+	
+	const char* const linesPath = "arrrgh_test_lines.rsp";
+	const char* const stringsPath = "arrrgh_test_strings.rsp";
+	const char* const laterNulPath = "arrrgh_test_later_nul.rsp";
+	writeFile( linesPath, "--count=3\r\n\"--name=Absolom, \\\"Absolom\\\"\"\n\nfirst path\n'second path'\n@not-expanded\n-f" );
+	writeFile( stringsPath, std::string( "one\0two\nlines\0\0three", 20 ));
+	
+	// Any NUL in the file makes it NUL-separated, even one after a newline.
+	//
+	writeFile( laterNulPath, std::string( "four\nlines\0five", 16 ));
+	
+	const auto unlabeled = [&]()
+	{
+		std::string joined;
+		parser.each_unlabeled_argument_view( [&]( std::string_view arg )
+											{
+												joined += "[";
+												joined += arg;
+												joined += "]";
+											} );
+		return joined;
+	};
+	
+	{
+		const char* argv[] = { "response", "before", "@arrrgh_test_lines.rsp", "@arrrgh_test_strings.rsp", "--", "@after" };
+		parser.parse( 6, argv );
+		
+		VERIFY_EQUAL( argCount.value(), 3 );
+		VERIFY_EQUAL( argName.value(), "Absolom, \"Absolom\"" );
+		VERIFY_TEST( argFast.value() );
+		VERIFY_EQUAL( unlabeled(), "[before][first path][second path][@not-expanded][one][two\nlines][three][@after]" );
+	}
+	
+	{
+		parser.clear_values();
+		const char* argv[] = { "response", "--count=1", "@arrrgh_test_later_nul.rsp" };
+		parser.parse( 3, argv );
+		
+		VERIFY_EQUAL( unlabeled(), "[four\nlines][five]" );
+	}
+	
+	// EXPECT FAILURE: A missing response file.
+	//
+	parser.clear_values();
+	try
+	{
+		const char* argv[] = { "response", "--count=1", "@arrrgh_test_missing.rsp" };
+		parser.parse( 3, argv );
+		std::cout << "Test failed: response file failed to fail." << std::endl;
+	}
+	catch( const arrrgh::parser::UnreadableResponseFile& e )
+	{
+		if( VERBOSE ) std::cerr << "Error parsing arguments: " << e.what() << std::endl;
+	}
+	
+	std::remove( linesPath );
+	std::remove( stringsPath );
+	std::remove( laterNulPath );
+}
+
+void testStreamingUnlabeledArgs()
+{
+	arrrgh::parser parser( "stream", "Tests handing unlabeled arguments to a sink." );
+	
+	const auto& argCount = parser.add< int >( "count", "c.", 'c', arrrgh::Required );
+	
+	// The sink sees each argument before parse() is done with the rest.
+	//
+	std::vector< std::pair< std::string_view, bool >> received;
+	parser.stream_unlabeled_arguments( [&]( std::string_view arg )
+									  {
+										  received.emplace_back( arg, argCount.assigned() );
+									  } );
+	
+	const char* argv[] = { "stream", "first", "second", "--count=2", "--", "--third" };
+	parser.parse( 6, argv );
+	
+	VERIFY_EQUAL( received.size(), 3u );
+	VERIFY_TEST( received.size() == 3 &&
+				 received[ 0 ] == std::make_pair( std::string_view{ "first" }, false ) &&
+				 received[ 1 ] == std::make_pair( std::string_view{ "second" }, false ) &&
+				 received[ 2 ] == std::make_pair( std::string_view{ "--third" }, true ));
+	
+	size_t collected = 0;
+	parser.each_unlabeled_argument_view( [&]( std::string_view ) { ++collected; } );
+	VERIFY_EQUAL( collected, 0u );
+	
+	// Back to collecting.
+	//
+	parser.clear_values();
+	parser.stream_unlabeled_arguments( nullptr );
+	parser.parse( 6, argv );
+	
+	parser.each_unlabeled_argument_view( [&]( std::string_view ) { ++collected; } );
+	VERIFY_EQUAL( collected, 3u );
+	VERIFY_EQUAL( received.size(), 3u );
+}
+
+void testStats()
+{
+	// Compiled out by default (see test_stats_arrrgh.cpp for the instrumented build).
+	//
+	arrrgh::parser parser( "stats", "Tests that parse instrumentation is off." );
+	parser.add< int >( "count", "c.", 'c' );
+	
+	const char* argv[] = { "stats", "--count=12" };
+	parser.parse( 2, argv );
+	VERIFY_EQUAL( parser.stats().parses, 0u );
+	VERIFY_EQUAL( parser.stats().tokens, 0u );
+}
+
+namespace
+{
+	constexpr arrrgh::option< int > requiredHeight{ "height", "h.", 'H', arrrgh::Required };
+	constexpr arrrgh::option< int > requiredWidth{ "", "w.", 'w', arrrgh::Required };
+	constexpr arrrgh::option< std::string > requiredName{ "name", "n.", '\0', arrrgh::Required };
+	constexpr arrrgh::option< bool > requiredFast{ "fast", "f.", 'f' };
+}
+
+void testMissingRequiredArgs()
+{
+	arrrgh::parser parser( "required", "Tests reporting missing required arguments." );
+	
+	const auto& argHeight = parser.add< int >( "height", "h.", 'H', arrrgh::Required );
+	parser.add< int >( "", "w.", 'w', arrrgh::Required );
+	parser.add< std::string >( "name", "n.", 'n', arrrgh::Required );
+	parser.add< bool >( "fast", "f.", 'f' );
+	
+	const auto missing = [&]( int argc, const char* argv[] ) -> std::string
+	{
+		parser.clear_values();
+		try
+		{
+			parser.parse( argc, argv );
+		}
+		catch( const arrrgh::parser::MissingRequiredArguments& e )
+		{
+			return e.what();
+		}
+		catch( const std::exception& e )
+		{
+			return std::string( "other: " ) + e.what();
+		}
+		return "";
+	};
+	
+	const char* none[] = { "required", "-f" };
+	const char* some[] = { "required", "--height=2", "-f" };
+	const char* all[] = { "required", "--name=x", "-w=3", "--height=2" };
+	
+	VERIFY_EQUAL( missing( 2, none ), "Missing required arguments: --height, -w, --name." );
+	VERIFY_EQUAL( missing( 3, some ), "Missing required arguments: -w, --name." );
+	VERIFY_EQUAL( missing( 4, all ), "" );
+	
+	// The same through a schema.
+	//
+	try
+	{
+		static_cast< const arrrgh::schema& >( parser ).parse( 3, some );
+		std::cout << "Test failed: schema failed to fail." << std::endl;
+	}
+	catch( const arrrgh::schema::MissingRequiredArguments& e )
+	{
+		VERIFY_EQUAL( std::string( e.what() ), "Missing required arguments: -w, --name." );
+	}
+	
+	// The same through a static_parser.
+	//
+	arrrgh::static_parser< requiredHeight, requiredWidth, requiredName, requiredFast > staticParser( "required", "Tests static_parser." );
+	try
+	{
+		staticParser.parse( 3, some );
+		std::cout << "Test failed: static_parser failed to fail." << std::endl;
+	}
+	catch( const arrrgh::parser::MissingRequiredArguments& e )
+	{
+		VERIFY_EQUAL( std::string( e.what() ), "Missing required arguments: -w, --name." );
+	}
+	
+	staticParser.clear_values();
+	try
+	{
+		staticParser.parse( 2, none );
+		std::cout << "Test failed: static_parser failed to fail." << std::endl;
+	}
+	catch( const arrrgh::parser::MissingRequiredArguments& e )
+	{
+		VERIFY_EQUAL( std::string( e.what() ), "Missing required arguments: --height, -w, --name." );
+	}
+	
+	// An argument that fails partway through assignment is still cleared.
+	//
+	const char* noValue[] = { "required", "--height" };
+	VERIFY_TEST( missing( 2, noValue ).find( "other: " ) == 0 );
+	VERIFY_TEST( argHeight.assigned() );
+	parser.clear_values();
+	VERIFY_TEST( !argHeight.assigned() );
+}
+
+void testTryParse()
+{
+	arrrgh::parser parser( "tryparse", "Tests parsing without exceptions." );
+	
+	const auto& argCount = parser.add< int >( "count", "c.", 'c' );
+	parser.add< std::string >( "name", "n.", 'n', arrrgh::Required );
+	parser.add< bool >( "fast", "f.", 'f' );
+	
+	const auto tryParse = [&]( int argc, const char* argv[] )
+	{
+		parser.clear_values();
+		return parser.try_parse( argc, argv );
+	};
+	
+	const char* good[] = { "tryparse", "--name=x", "-fc=3" };
+	const arrrgh::parse_status succeeded = tryParse( 3, good );
+	VERIFY_TEST( succeeded );
+	VERIFY_EQUAL( succeeded.argumentIndex, -1 );
+	VERIFY_EQUAL( argCount.value(), 3 );
+	
+	const char* unknownLong[] = { "tryparse", "--name=x", "--colour=red" };
+	arrrgh::parse_status status = tryParse( 3, unknownLong );
+	VERIFY_TEST( status.error == arrrgh::parse_error::unknown_argument );
+	VERIFY_EQUAL( status.argumentIndex, 2 );
+	VERIFY_EQUAL( status.offset, 0u );
+	VERIFY_EQUAL( parser.error_message( status ), "Unrecognized argument \"--colour\"." );
+	
+	const char* unknownLetter[] = { "tryparse", "--name=x", "-fz" };
+	status = tryParse( 3, unknownLetter );
+	VERIFY_TEST( status.error == arrrgh::parse_error::unknown_argument );
+	VERIFY_EQUAL( status.argumentIndex, 2 );
+	VERIFY_EQUAL( status.offset, 2u );
+	VERIFY_EQUAL( parser.error_message( status ), "Unrecognized argument \"-z\"." );
+	
+	const char* badValue[] = { "tryparse", "-f", "--count=lots", "--name=x" };
+	status = tryParse( 4, badValue );
+	VERIFY_TEST( status.error == arrrgh::parse_error::value_conversion );
+	VERIFY_EQUAL( status.argumentIndex, 2 );
+	VERIFY_EQUAL( status.offset, 8u );
+	VERIFY_EQUAL( parser.error_message( status ), "Could not convert value 'lots' to the desired argument type." );
+	
+	const char* noValue[] = { "tryparse", "--name" };
+	status = tryParse( 2, noValue );
+	VERIFY_TEST( status.error == arrrgh::parse_error::missing_value );
+	VERIFY_EQUAL( status.argumentIndex, 1 );
+	
+	const char* badCharacter[] = { "tryparse", "-f3" };
+	status = tryParse( 2, badCharacter );
+	VERIFY_TEST( status.error == arrrgh::parse_error::invalid_argument_character );
+	VERIFY_EQUAL( status.offset, 2u );
+	VERIFY_EQUAL( parser.error_message( status ), "Invalid argument with character '3'." );
+	
+	const char* noName[] = { "tryparse", "-f" };
+	status = tryParse( 2, noName );
+	VERIFY_TEST( status.error == arrrgh::parse_error::missing_required_arguments );
+	VERIFY_EQUAL( status.argumentIndex, -1 );
+	VERIFY_EQUAL( parser.error_message( status ), "Missing required arguments: --name." );
+	
+	VERIFY_TEST( parser.try_parse( 0, nullptr ).error == arrrgh::parse_error::no_arguments );
+	
+	// Failing, even with a message's worth of text at fault, allocates nothing.
+	//
+	const std::string longName = "--" + std::string( 200, 'q' );
+	const char* unknownLongName[] = { "tryparse", longName.c_str() };
+	tryParse( 2, unknownLongName );
+	
+	const size_t allocationsBefore = allocationCount;
+	for( int i = 0; i < 10; ++i )
+	{
+		VERIFY_TEST( !tryParse( 2, unknownLongName ));
+		VERIFY_TEST( !tryParse( 4, badValue ));
+		VERIFY_TEST( !tryParse( 2, noName ));
+	}
+	VERIFY_EQUAL( allocationCount - allocationsBefore, 0u );
+	
+	// parse() throws the same errors.
+	//
+	try
+	{
+		parser.clear_values();
+		parser.parse( 4, badValue );
+		std::cout << "Test failed: parse() failed to fail." << std::endl;
+	}
+	catch( const arrrgh::argument< int >::ValueConversionError& e )
+	{
+		VERIFY_EQUAL( std::string( e.what() ), "Could not convert value 'lots' to the desired argument type." );
+	}
+}
+
+namespace
+{
+	template< typename ArgumentT, typename = void >
+	struct has_values_span : std::false_type {};
+	
+	template< typename ArgumentT >
+	struct has_values_span< ArgumentT, std::void_t< decltype( std::declval< const ArgumentT& >().values() ) >> : std::true_type {};
+}
+
+void testMultiValueArgs()
+{
+	arrrgh::parser parser( "multi", "Tests arguments that collect a value per appearance." );
+	
+	auto& argIncludes = parser.add< std::vector< std::string_view >>( "include", "Include directories.", 'I' );
+	const auto& argLevels = parser.add< std::vector< int >>( "level", "Levels.", 'l', arrrgh::Optional, { 7, 8 } );
+	const auto& argVerbose = parser.add< std::vector< bool >>( "verbose", "More output.", 'v' );
+	const arrrgh::argument_abstract& levels = argLevels;
+	
+	const char* argv[] = { "multi", "-I=a", "--level=1", "--include=b/c", "-vvv", "file", "-l=2", "-I=d" };
+	
+	VERIFY_EQUAL( argLevels.value().size(), 2u );
+	parser.parse( 8, argv );
+	
+	VERIFY_EQUAL( argIncludes.values().size(), 3u );
+	VERIFY_EQUAL( argIncludes.values()[ 0 ], "a" );
+	VERIFY_EQUAL( argIncludes.values()[ 1 ], "b/c" );
+	VERIFY_EQUAL( argIncludes.values()[ 2 ], "d" );
+	VERIFY_EQUAL( levels.converted_value_string(), "1,2" );
+	VERIFY_EQUAL( argVerbose.value().size(), 3u );
+	
+	// std::vector< bool > has no contiguous storage, so no values() span; value() counts.
+	//
+	static_assert( has_values_span< arrrgh::argument< std::vector< int >>>::value, "" );
+	static_assert( !has_values_span< arrrgh::argument< std::vector< bool >>>::value, "" );
+	
+	int unlabeledCount = 0;
+	parser.each_unlabeled_argument( [&]( const std::string& ) { ++unlabeledCount; } );
+	VERIFY_EQUAL( unlabeledCount, 1 );
+	
+	parser.clear_values();
+	VERIFY_TEST( argIncludes.values().empty() );
+	VERIFY_EQUAL( levels.converted_value_string(), "7,8" );
+	
+	// A bad element fails the parse without disturbing those before it.
+	//
+	const char* badLevel[] = { "multi", "-l=1", "-l=x" };
+	try
+	{
+		parser.parse( 3, badLevel );
+		std::cout << "Test failed: bad level failed to fail." << std::endl;
+	}
+	catch( const arrrgh::argument< std::vector< int >>::ValueConversionError& )
+	{
+		VERIFY_EQUAL( levels.converted_value_string(), "1" );
+	}
+	parser.clear_values();
+	
+	// Thousands of repetitions append to one reserved vector, allocating nothing once warmed up.
+	//
+	constexpr size_t includeCount = 5000;
+	std::vector< std::string > includeText;
+	for( size_t i = 0; i < includeCount; ++i )
+	{
+		includeText.push_back( "-I=/usr/include/dir" + std::to_string( i ));
+	}
+	std::vector< const char* > manyArgv{ "multi" };
+	for( const auto& text : includeText )
+	{
+		manyArgv.push_back( text.c_str() );
+	}
+	
+	argIncludes.reserve( includeCount );
+	parser.parse( static_cast< int >( manyArgv.size() ), manyArgv.data() );
+	parser.clear_values();
+	
+	const size_t allocationsBefore = allocationCount;
+	parser.parse( static_cast< int >( manyArgv.size() ), manyArgv.data() );
+	VERIFY_EQUAL( allocationCount - allocationsBefore, 0u );
+	VERIFY_EQUAL( argIncludes.values().size(), includeCount );
+	VERIFY_EQUAL( argIncludes.values()[ includeCount - 1 ], "/usr/include/dir4999" );
+	
+	// The same through a schema.
+	//
+	parser.clear_values();
+	const auto result = static_cast< const arrrgh::schema& >( parser ).parse( 8, argv );
+	VERIFY_EQUAL( result.value( argIncludes ).size(), 3u );
+	VERIFY_EQUAL( result.value( argLevels ).size(), 2u );
+	VERIFY_EQUAL( result.value( argLevels )[ 1 ], 2 );
+}
+
+void testNumberLists()
+{
+	arrrgh::parser parser( "lists", "Tests comma-separated number lists." );
+	
+	const auto& argWeights = parser.add< std::vector< float >>( "weights", "Weights.", 'w' );
+	const auto& argIds = parser.add< std::vector< int >>( "ids", "Ids." );
+	const auto& argSmall = parser.add< std::vector< signed char >>( "small", "Small numbers." );
+	
+	const char* argv[] = { "lists", "--weights=1.5,2, -3e2", "--ids=1,22,333,4444,55555,666666,7777777,88888888",
+						   "--ids=999999999,-5,+6,-2147483648", "--small=127,-128" };
+	parser.parse( 5, argv );
+	
+	VERIFY_EQUAL( argWeights.values().size(), 3u );
+	VERIFY_EQUAL( argWeights.values()[ 2 ], -300.0f );
+	
+	const std::vector< int > expectedIds{ 1, 22, 333, 4444, 55555, 666666, 7777777, 88888888, 999999999, -5, 6, -2147483647 - 1 };
+	VERIFY_TEST( argIds.value() == expectedIds );
+	VERIFY_EQUAL( argSmall.values()[ 1 ], -128 );
+	
+	// Long enough lists to take the vectorized path, with elements that straddle its blocks.
+	//
+	std::string idText = "--ids=";
+	std::vector< int > expectedLong;
+	for( int i = 0; i < 10000; ++i )
+	{
+		const int id = ( i * 7919 ) % 1000003 - 500000;
+		expectedLong.push_back( id );
+		idText += ( i ? "," : "" ) + std::to_string( id );
+	}
+	const char* longArgv[] = { "lists", idText.c_str() };
+	parser.clear_values();
+	parser.parse( 2, longArgv );
+	VERIFY_TEST( argIds.value() == expectedLong );
+	
+	// A bad element is reported by its position, and none of its list is kept.
+	//
+	const auto failure = [&]( const char* arg ) -> std::string
+	{
+		const char* badArgv[] = { "lists", "--ids=7", arg };
+		parser.clear_values();
+		const arrrgh::parse_status status = parser.try_parse( 3, badArgv );
+		VERIFY_TEST( !status || std::string( arg ) == "--ids=1,2" );
+		if( status )
+		{
+			return "";
+		}
+		VERIFY_EQUAL( status.argumentIndex, 2 );
+		VERIFY_EQUAL( argIds.value().size(), 1u );
+		return std::to_string( status.offset ) + " " + parser.error_message( status );
+	};
+	
+	VERIFY_EQUAL( failure( "--ids=1,2" ), "" );
+	VERIFY_EQUAL( failure( "--ids=1,2,x,4" ), "10 Could not convert element 2 ('x') of value '1,2,x,4' to the desired argument type." );
+	VERIFY_EQUAL( failure( "--ids=1,,2" ), "8 Could not convert element 1 ('') of value '1,,2' to the desired argument type." );
+	VERIFY_EQUAL( failure( "--ids=1,2," ), "10 Could not convert element 2 ('') of value '1,2,' to the desired argument type." );
+	VERIFY_EQUAL( failure( "--ids=3x" ), "6 Could not convert value '3x' to the desired argument type." );
+	VERIFY_EQUAL( failure( "--ids=1,2147483648" ), "8 Could not convert element 1 ('2147483648') of value '1,2147483648' to the desired argument type." );
+	VERIFY_EQUAL( failure( "--small=1,128" ), "10 Could not convert element 1 ('128') of value '1,128' to the desired argument type." );
+	
+	try
+	{
+		const char* badArgv[] = { "lists", "--weights=1,2.5.3" };
+		parser.clear_values();
+		parser.parse( 2, badArgv );
+		std::cout << "Test failed: bad weights failed to fail." << std::endl;
+	}
+	catch( const arrrgh::argument< std::vector< float >>::ValueConversionError& e )
+	{
+		VERIFY_EQUAL( std::string( e.what() ), "Could not convert element 1 ('2.5.3') of value '1,2.5.3' to the desired argument type." );
+	}
+}
+
+void testSubcommands()
+{
+	arrrgh::parser parser( "tool", "Tests subcommands." );
+	const auto& argVerbose = parser.add< bool >( "verbose", "Talk more.", 'v' );
+	
+	int buildRegistrations = 0;
+	int runRegistrations = 0;
+	const arrrgh::argument< std::string >* argTarget = nullptr;
+	const arrrgh::argument< int >* argJobs = nullptr;
+	
+	parser.add_subcommand( "build", "Builds things.", [&]( arrrgh::parser& build )
+						   {
+							   ++buildRegistrations;
+							   argTarget = &build.add< std::string >( "target", "What to build.", 't', arrrgh::Required );
+							   argJobs = &build.add< int >( "jobs", "How many at once.", 'j', arrrgh::Optional, 1 );
+						   } );
+	parser.add_subcommand( "run", "Runs things.", [&]( arrrgh::parser& run )
+						   {
+							   ++runRegistrations;
+							   run.add< bool >( "fast", "Run fast.", 'f' );
+						   } );
+	
+	// Switches before the subcommand are the parent's; the rest are the subcommand's.
+	//
+	const char* argv[] = { "tool", "-v", "build", "--target=all", "-j=8", "input.txt" };
+	parser.parse( 6, argv );
+	
+	VERIFY_TEST( argVerbose.value() );
+	VERIFY_EQUAL( parser.subcommand_name(), "build" );
+	VERIFY_EQUAL( buildRegistrations, 1 );
+	VERIFY_EQUAL( runRegistrations, 0 );
+	VERIFY_EQUAL( argTarget->value(), "all" );
+	VERIFY_EQUAL( argJobs->value(), 8 );
+	
+	std::vector< std::string > unlabeled;
+	parser.subcommand_parser()->each_unlabeled_argument( [&]( const std::string& arg ) { unlabeled.push_back( arg ); } );
+	VERIFY_EQUAL( unlabeled.size(), 1u );
+	VERIFY_EQUAL( unlabeled[ 0 ], "input.txt" );
+	
+	// The subcommand's parser is kept and reused.
+	//
+	parser.clear_values();
+	VERIFY_TEST( !parser.subcommand_parser() );
+	VERIFY_EQUAL( argJobs->value(), 1 );
+	
+	const char* again[] = { "tool", "build", "-t=lib" };
+	parser.parse( 3, again );
+	VERIFY_EQUAL( buildRegistrations, 1 );
+	VERIFY_EQUAL( argTarget->value(), "lib" );
+	VERIFY_TEST( !argVerbose.value() );
+	
+	// Errors in the subcommand are reported with their index in the whole command line.
+	//
+	const char* badSwitch[] = { "tool", "-v", "run", "-f", "--bogus" };
+	parser.clear_values();
+	arrrgh::parse_status status = parser.try_parse( 5, badSwitch );
+	VERIFY_TEST( status.error == arrrgh::parse_error::unknown_argument );
+	VERIFY_EQUAL( status.argumentIndex, 4 );
+	VERIFY_EQUAL( parser.error_message( status ), "Unrecognized argument \"--bogus\"." );
+	VERIFY_EQUAL( runRegistrations, 1 );
+	
+	const char* missingTarget[] = { "tool", "build" };
+	try
+	{
+		parser.clear_values();
+		parser.parse( 2, missingTarget );
+		std::cout << "Test failed: missing target failed to fail." << std::endl;
+	}
+	catch( const arrrgh::parser::MissingRequiredArguments& e )
+	{
+		VERIFY_EQUAL( std::string( e.what() ), "Missing required arguments: --target." );
+	}
+	
+	const char* badCommand[] = { "tool", "-v", "inspect" };
+	parser.clear_values();
+	status = parser.try_parse( 3, badCommand );
+	VERIFY_TEST( status.error == arrrgh::parse_error::unknown_subcommand );
+	VERIFY_EQUAL( status.argumentIndex, 2 );
+	VERIFY_EQUAL( parser.error_message( status ), "Unrecognized command \"inspect\"." );
+	
+	const char* noCommand[] = { "tool", "-v" };
+	parser.clear_values();
+	parser.parse( 2, noCommand );
+	VERIFY_TEST( !parser.subcommand_parser() );
+	
+	// Usage.
+	//
+	std::ostringstream usage;
+	parser.show_usage( usage );
+	VERIFY_TEST( usage.str().find( "commands:\n    build\n\t\tBuilds things." ) != std::string::npos );
+	
+	std::ostringstream buildUsage;
+	VERIFY_TEST( parser.show_subcommand_usage( "build", buildUsage ));
+	VERIFY_TEST( buildUsage.str().find( "usage: tool build" ) != std::string::npos );
+	VERIFY_TEST( buildUsage.str().find( "--target" ) != std::string::npos );
+	VERIFY_TEST( !parser.show_subcommand_usage( "inspect", buildUsage ));
+	
+	// A registration that throws leaves no subcommand active, and the next parse registers it again.
+	//
+	arrrgh::parser flaky( "tool", "Tests a registration that throws." );
+	bool throwOnRegistration = true;
+	flaky.add_subcommand( "build", "Builds things.", [&]( arrrgh::parser& build )
+						  {
+							  build.add< bool >( "fast", "Build fast.", 'f' );
+							  if( throwOnRegistration )
+							  {
+								  throw std::runtime_error( "registration failed" );
+							  }
+						  } );
+	
+	const char* flakyArgv[] = { "tool", "build", "-f" };
+	try
+	{
+		flaky.try_parse( 3, flakyArgv );
+		std::cout << "Test failed: throwing registration failed to fail." << std::endl;
+	}
+	catch( const std::runtime_error& )
+	{}
+	VERIFY_EQUAL( flaky.subcommand_name(), "" );
+	VERIFY_TEST( !flaky.subcommand_parser() );
+	flaky.clear_values();
+	
+	throwOnRegistration = false;
+	VERIFY_TEST( flaky.try_parse( 3, flakyArgv ));
+	VERIFY_EQUAL( flaky.subcommand_name(), "build" );
+	flaky.clear_values();
+}
+
+void testEnvironment()
+{
+	arrrgh::parser parser( "tool", "Tests environment variable fallback." );
+	
+	const auto& argThreads = parser.add< int >( "threads", "Threads.", 't', arrrgh::Optional, 1 );
+	const auto& argMaxJobs = parser.add< int >( "max-jobs", "Jobs.", '\0', arrrgh::Optional, 1 );
+	const auto& argName = parser.add< std::string >( "name", "Name.", 'n', arrrgh::Required );
+	const auto& argFast = parser.add< bool >( "fast", "Fast.", 'f' );
+	
+	parser.bind_environment_prefix( "MYTOOL_" );
+	parser.bind_environment( argName, "TOOL_NAME" );
+	
+	char threadsVariable[] = "MYTOOL_THREADS=4";
+	const char* environment[] = { "PATH=/bin", threadsVariable, "MYTOOL_MAX_JOBS=9", "MYTOOL_NAME=from-prefix",
+								  "TOOL_NAME=from-binding", "MYTOOL_FAST=", "MYTOOL_LATE=5", nullptr };
+	parser.set_environment( environment );
+	
+	// The command line beats the environment, which beats the default.
+	//
+	const char* argv[] = { "tool", "-t=2" };
+	parser.parse( 2, argv );
+	VERIFY_EQUAL( argThreads.value(), 2 );
+	VERIFY_EQUAL( argMaxJobs.value(), 9 );
+	VERIFY_EQUAL( argName.value(), "from-binding" );
+	VERIFY_TEST( !argFast.assigned() );
+	
+	// Arguments added later get names too, and values are copied unless borrowed.
+	//
+	const auto& argLate = parser.add< int >( "late", "Added late." );
+	const char* bare[] = { "tool" };
+	parser.clear_values();
+	parser.parse( 1, bare );
+	VERIFY_EQUAL( argLate.value(), 5 );
+	VERIFY_EQUAL( argThreads.value(), 4 );
+	
+	threadsVariable[ 15 ] = '8';
+	VERIFY_EQUAL( argThreads.value_view(), "4" );
+	
+	parser.clear_values();
+	parser.parse( 1, bare );
+	
+	const size_t allocationsBefore = allocationCount;
+	parser.clear_values();
+	parser.parse( 1, bare );
+	VERIFY_EQUAL( allocationCount - allocationsBefore, 0u );
+	VERIFY_EQUAL( argThreads.value(), 8 );
+	
+	const char* badEnvironment[] = { "TOOL_NAME=x", "MYTOOL_THREADS=lots", nullptr };
+	parser.set_environment( badEnvironment );
+	parser.clear_values();
+	const arrrgh::parse_status status = parser.try_parse( 1, bare );
+	VERIFY_TEST( status.error == arrrgh::parse_error::value_conversion );
+	VERIFY_EQUAL( status.argumentIndex, -1 );
+	VERIFY_EQUAL( parser.error_message( status ),
+				  "Could not convert value 'lots' to the desired argument type. (From environment variable MYTOOL_THREADS.)" );
+	
+	// Without any, a required argument is still missing.
+	//
+	const char* emptyEnvironment[] = { nullptr };
+	parser.set_environment( emptyEnvironment );
+	parser.clear_values();
+	VERIFY_TEST( parser.try_parse( 1, bare ).error == arrrgh::parse_error::missing_required_arguments );
+}
+
+namespace
+{
+	// A value whose conversion depends on more than its text, as a path that must exist would.
+	//
+	struct mount_point
+	{
+		std::string name;
+		
+		static bool s_available;
+		
+		bool operator==( const mount_point& other ) const { return name == other.name; }
+	};
+	
+	bool mount_point::s_available = true;
+	
+	std::ostream& operator<<( std::ostream& out, const mount_point& m )
+	{
+		return out << m.name;
+	}
+}
+
+namespace arrrgh
+{
+	template<>
+	struct type_traits< mount_point >
+	{
+		static constexpr bool always_requires_value() { return true; }
+		static constexpr const char* name() { return "MOUNT"; }
+		
+		static bool parse( const char* first, const char* last, mount_point& result )
+		{
+			result.name.assign( first, last );
+			return mount_point::s_available;
+		}
+	};
+}
+
+void testConfigFile()
+{
+	arrrgh::parser parser( "service", "Tests reading values from a config file." );
+	
+	const auto& argThreads = parser.add< int >( "threads", "Threads.", 't', arrrgh::Optional, 1 );
+	const auto& argRatio = parser.add< double >( "ratio", "Ratio.", 'r' );
+	const auto& argName = parser.add< std::string >( "name", "Name.", 'n', arrrgh::Required );
+	const auto& argWeights = parser.add< std::vector< int >>( "weights", "Weights.", 'w' );
+	const auto& argFast = parser.add< bool >( "fast", "Fast.", 'f' );
+	
+	const auto readFile = []( const std::string& path )
+	{
+		std::ifstream in( path, std::ios::binary );
+		return std::string( std::istreambuf_iterator< char >( in ), std::istreambuf_iterator< char >() );
+	};
+	
+	const auto writeFile = []( const std::string& path, const std::string& contents )
+	{
+		std::ofstream( path, std::ios::binary ) << contents;
+	};
+	
+	const std::string configPath = "arrrgh_test.conf";
+	const std::string cachePath = configPath + ".cache";
+	std::remove( cachePath.c_str() );
+	writeFile( configPath, "# Service settings\r\nthreads = 4\r\n\r\n  ratio=2.5\nname = \"My service\"\n; weights\nweights = 1,2\nweights=3\nfast =\n" );
+	
+	parser.set_config_file( configPath, true );
+	
+	// The command line beats the config file, which beats the default.
+	//
+	const char* argv[] = { "service", "-t=2" };
+	parser.parse( 2, argv );
+	VERIFY_EQUAL( argThreads.value(), 2 );
+	VERIFY_EQUAL( argRatio.value(), 2.5 );
+	VERIFY_EQUAL( argName.value(), "My service" );
+	VERIFY_TEST( argWeights.value() == std::vector< int >( { 1, 2, 3 } ));
+	VERIFY_TEST( argFast.value() );
+	
+	// The cache is used while the file is unchanged: doctoring its copy of the ratio shows through.
+	//
+	std::string cache = readFile( cachePath );
+	const double oldRatio = 2.5, newRatio = 3.5;
+	const size_t ratioAt = cache.find( std::string( reinterpret_cast< const char* >( &oldRatio ), sizeof( oldRatio )));
+	VERIFY_TEST( ratioAt != std::string::npos );
+	cache.replace( ratioAt, sizeof( newRatio ), reinterpret_cast< const char* >( &newRatio ), sizeof( newRatio ));
+	writeFile( cachePath, cache );
+	
+	const char* bare[] = { "service" };
+	parser.clear_values();
+	parser.parse( 1, bare );
+	VERIFY_EQUAL( argThreads.value(), 4 );
+	VERIFY_EQUAL( argRatio.value(), 3.5 );
+	VERIFY_EQUAL( argName.value(), "My service" );
+	VERIFY_TEST( argWeights.value() == std::vector< int >( { 1, 2, 3 } ));
+	
+	// ...and passed over once the file changes, even to text of the same size.
+	//
+	writeFile( configPath, "# Service settings\r\nthreads = 5\r\n\r\n  ratio=2.5\nname = \"My service\"\n; weights\nweights = 1,2\nweights=3\nfast =\n" );
+	parser.clear_values();
+	parser.parse( 1, bare );
+	VERIFY_EQUAL( argThreads.value(), 5 );
+	VERIFY_EQUAL( argRatio.value(), 2.5 );
+	
+	// A truncated cache is passed over too.
+	//
+	writeFile( cachePath, readFile( cachePath ).substr( 0, 60 ));
+	parser.clear_values();
+	parser.parse( 1, bare );
+	VERIFY_EQUAL( argThreads.value(), 5 );
+	VERIFY_TEST( argWeights.value() == std::vector< int >( { 1, 2, 3 } ));
+	
+	// So is one whose list payload isn't a whole number of elements. Its length is the 8 bytes before the text.
+	//
+	cache = readFile( cachePath );
+	const size_t weightsAt = cache.find( std::string( "1,2\0", 4 ));
+	VERIFY_TEST( weightsAt != std::string::npos && weightsAt >= 8 );
+	const uint64_t oddLength = 6;
+	cache.replace( weightsAt - 8, sizeof( oddLength ), reinterpret_cast< const char* >( &oddLength ), sizeof( oddLength ));
+	writeFile( cachePath, cache );
+	parser.clear_values();
+	parser.parse( 1, bare );
+	VERIFY_TEST( argWeights.value() == std::vector< int >( { 1, 2, 3 } ));
+	
+	// Errors give the line.
+	//
+	writeFile( configPath, "threads = 4\nratio = fast\n" );
+	parser.clear_values();
+	arrrgh::parse_status status = parser.try_parse( 1, bare );
+	VERIFY_TEST( status.error == arrrgh::parse_error::value_conversion );
+	VERIFY_EQUAL( status.offset, 20u );
+	VERIFY_EQUAL( parser.error_message( status ),
+				  "Could not convert value 'fast' to the desired argument type. (At line 2 of config file \"arrrgh_test.conf\".)" );
+	
+	writeFile( configPath, "threads = 4\n\nspeed = 9\n" );
+	parser.clear_values();
+	status = parser.try_parse( 1, bare );
+	VERIFY_TEST( status.error == arrrgh::parse_error::unknown_config_key );
+	VERIFY_EQUAL( parser.error_message( status ), "Unrecognized argument \"speed\". (At line 3 of config file \"arrrgh_test.conf\".)" );
+	
+	// EXPECT FAILURE: A line without '='.
+	//
+	writeFile( configPath, "threads 4\n" );
+	parser.clear_values();
+	try
+	{
+		parser.parse( 1, bare );
+		std::cout << "Test failed: malformed config file failed to fail." << std::endl;
+	}
+	catch( const arrrgh::parser::MalformedConfigFile& e )
+	{
+		if( VERBOSE ) std::cerr << "Error parsing arguments: " << e.what() << std::endl;
+	}
+	
+	// A cached entry that no longer converts is reported against the file's text.
+	//
+	arrrgh::parser mounts( "mounts", "Tests a cached value that stops converting." );
+	const auto& argMountThreads = mounts.add< int >( "threads", "Threads.", 't' );
+	const auto& argMount = mounts.add< mount_point >( "mount", "Mount.", 'm' );
+	mounts.set_config_file( configPath, true );
+	
+	std::remove( cachePath.c_str() );
+	writeFile( configPath, "threads = 4\nmount = data\n" );
+	mounts.parse( 1, bare );
+	VERIFY_EQUAL( argMount.value().name, "data" );
+	VERIFY_TEST( !readFile( cachePath ).empty() );
+	
+	mount_point::s_available = false;
+	mounts.clear_values();
+	status = mounts.try_parse( 1, bare );
+	VERIFY_TEST( status.error == arrrgh::parse_error::value_conversion );
+	VERIFY_EQUAL( status.offset, 20u );
+	VERIFY_EQUAL( mounts.error_message( status ),
+				  "Could not convert value 'data' to the desired argument type. (At line 2 of config file \"arrrgh_test.conf\".)" );
+	
+	mount_point::s_available = true;
+	mounts.clear_values();
+	mounts.parse( 1, bare );
+	VERIFY_EQUAL( argMountThreads.value(), 4 );
+	VERIFY_EQUAL( argMount.value().name, "data" );
+	mounts.clear_values();
+	
+	std::remove( configPath.c_str() );
+	std::remove( cachePath.c_str() );
+	
+	parser.clear_values();
+	VERIFY_TEST( parser.try_parse( 1, bare ).error == arrrgh::parse_error::unreadable_config_file );
+}
+
+void testAbbreviationsAndCompletion()
+{
+	arrrgh::parser parser( "abbrev", "Tests abbreviated long forms and shell completion." );
+	
+	const auto& argVerbose = parser.add< bool >( "verbose", "Verbose." );
+	const auto& argVerbatim = parser.add< bool >( "verbatim", "Verbatim." );
+	const auto& argVer = parser.add< bool >( "ver", "Version." );
+	const auto& argCount = parser.add< int >( "count", "Count.", 'c' );
+	
+	// Not unless allowed.
+	//
+	const char* abbreviated[] = { "abbrev", "--verbo", "--co=3", "--ver" };
+	VERIFY_TEST( parser.try_parse( 4, abbreviated ).error == arrrgh::parse_error::unknown_argument );
+	
+	parser.allow_abbreviations();
+	parser.clear_values();
+	parser.parse( 4, abbreviated );
+	VERIFY_TEST( argVerbose.value() );
+	VERIFY_TEST( !argVerbatim.assigned() );
+	VERIFY_TEST( argVer.value() );		// An exact match, although "verbose" and "verbatim" start with it.
+	VERIFY_EQUAL( argCount.value(), 3 );
+	
+	// EXPECT FAILURE: An ambiguous prefix.
+	//
+	const char* ambiguous[] = { "abbrev", "--verb" };
+	parser.clear_values();
+	const arrrgh::parse_status status = parser.try_parse( 2, ambiguous );
+	VERIFY_TEST( status.error == arrrgh::parse_error::ambiguous_argument );
+	VERIFY_EQUAL( parser.error_message( status ), "Ambiguous argument \"--verb\" could be --verbatim or --verbose." );
+	
+	parser.clear_values();
+	try
+	{
+		parser.parse( 2, ambiguous );
+		std::cout << "Test failed: ambiguous argument failed to fail." << std::endl;
+	}
+	catch( const arrrgh::parser::AmbiguousArgument& e )
+	{
+		if( VERBOSE ) std::cerr << "Error parsing arguments: " << e.what() << std::endl;
+	}
+	
+	// Completion, as bash's "complete -C" asks for it and directly.
+	//
+	parser.add_subcommand( "vacuum", "Cleans up.", []( arrrgh::parser& ) {} );
+	parser.add_subcommand( "count-words", "Counts words.", []( arrrgh::parser& ) {} );
+	
+	const auto completions = [&]( std::vector< const char* > argv )
+	{
+		std::ostringstream out;
+		VERIFY_TEST( parser.complete( static_cast< int >( argv.size() ), argv.data(), out ));
+		return out.str();
+	};
+	
+	VERIFY_EQUAL( completions( { "abbrev", "--arrrgh-complete", "abbrev", "--ver", "abbrev" } ), "--ver\n--verbatim\n--verbose\n" );
+	VERIFY_EQUAL( completions( { "abbrev", "--arrrgh-complete", "--h" } ), "--help\n" );
+	VERIFY_EQUAL( completions( { "abbrev", "--arrrgh-complete", "v" } ), "vacuum\n" );
+	VERIFY_EQUAL( completions( { "abbrev", "--arrrgh-complete", "--x" } ), "" );
+	VERIFY_EQUAL( completions( { "abbrev", "--arrrgh-complete" } ),
+				  "vacuum\ncount-words\n--count\n--help\n--ver\n--verbatim\n--verbose\n" );
+	
+	std::ostringstream out;
+	VERIFY_TEST( !parser.complete( 2, abbreviated, out ));
+	VERIFY_TEST( out.str().empty() );
+}
+
+void testSuggestions()
+{
+	// The bit-parallel distance agrees with the textbook one.
+	//
+	const auto levenshtein = []( const std::string& a, const std::string& b )
+	{
+		std::vector< size_t > row( b.size() + 1 );
+		for( size_t j = 0; j <= b.size(); ++j ) row[ j ] = j;
+		for( size_t i = 1; i <= a.size(); ++i )
+		{
+			size_t diagonal = row[ 0 ];
+			row[ 0 ] = i;
+			for( size_t j = 1; j <= b.size(); ++j )
+			{
+				const size_t above = row[ j ];
+				row[ j ] = std::min( { row[ j ] + 1, row[ j - 1 ] + 1, diagonal + ( a[ i - 1 ] != b[ j - 1 ] ) } );
+				diagonal = above;
+			}
+		}
+		return row.back();
+	};
+	
+	const std::string words[] = { "a", "ab", "ba", "abc", "kitten", "sitting", "verbose", "verbatim", "",
+								  "option-1234", "optoin-1234", std::string( 64, 'x' ), std::string( 60, 'x' ) + "yxyx" };
+	for( const auto& pattern : words )
+	{
+		if( pattern.empty() ) continue;
+		const arrrgh::detail::edit_distance_pattern bitParallel( pattern );
+		for( const auto& text : words )
+		{
+			VERIFY_EQUAL( bitParallel.distance( text, 100 ), levenshtein( pattern, text ));
+		}
+	}
+	
+	arrrgh::parser parser( "suggest", "Tests suggestions for unknown arguments." );
+	parser.add< bool >( "verbose", "Verbose." );
+	parser.add< bool >( "version", "Version." );
+	parser.add< std::string >( "color", "Color." );
+	parser.add< std::string >( "colour", "Colour." );
+	parser.add< int >( "count", "Count.", 'c' );
+	
+	const auto message = [&]( const char* arg )
+	{
+		const char* argv[] = { "suggest", arg };
+		parser.clear_values();
+		return parser.error_message( parser.try_parse( 2, argv ));
+	};
+	
+	VERIFY_EQUAL( message( "--verbos" ), "Unrecognized argument \"--verbos\". Did you mean \"--verbose\"?" );
+	VERIFY_EQUAL( message( "--versoin" ), "Unrecognized argument \"--versoin\". Did you mean \"--version\"?" );
+	VERIFY_EQUAL( message( "--colr=red" ), "Unrecognized argument \"--colr\". Did you mean \"--color\"?" );
+	VERIFY_EQUAL( message( "--coutn" ), "Unrecognized argument \"--coutn\". Did you mean \"--count\"?" );
+	VERIFY_EQUAL( message( "--colou=red" ), "Unrecognized argument \"--colou\". Did you mean \"--color\" or \"--colour\"?" );
+	VERIFY_EQUAL( message( "--xyzzy" ), "Unrecognized argument \"--xyzzy\"." );
+	VERIFY_EQUAL( message( "-z" ), "Unrecognized argument \"-z\"." );
+	
+	// A shared schema suggests too.
+	//
+	arrrgh::schema schema( "suggest", "Tests suggestions from a schema." );
+	schema.add< std::string >( "name", "Name." );
+	try
+	{
+		const char* argv[] = { "suggest", "--nam=x" };
+		schema.parse( 2, argv );
+		std::cout << "Test failed: unknown argument failed to fail." << std::endl;
+	}
+	catch( const arrrgh::schema::UnknownArgument& e )
+	{
+		VERIFY_EQUAL( std::string( e.what() ), "Unrecognized argument \"--nam\". Did you mean \"--name\"?" );
+	}
+}
+
+enum class compression { zstd, lz4, none };
+
+namespace arrrgh
+{
+	template<>
+	struct choice_traits< compression >
+	{
+		static constexpr std::array< std::pair< std::string_view, compression >, 3 > choices{{
+			{ "zstd", compression::zstd }, { "lz4", compression::lz4 }, { "none", compression::none } }};
+	};
+}
+
+namespace
+{
+	constexpr arrrgh::option< compression > staticCompression{ "compression", "How to compress.", 'z', arrrgh::Optional, compression::lz4 };
+}
+
+void testChoices()
+{
+	arrrgh::parser parser( "choices", "Tests enum arguments." );
+	const auto& mode = parser.add< compression >( "compression", "How to compress.", 'z', arrrgh::Optional, compression::none );
+	const auto& fallbacks = parser.add< std::vector< compression >>( "fallbacks", "What to try next." );
+	
+	const auto parse = [&]( std::initializer_list< const char* > args )
+	{
+		std::vector< const char* > argv{ "choices" };
+		argv.insert( argv.end(), args );
+		parser.clear_values();
+		return parser.try_parse( static_cast< int >( argv.size() ), argv.data() );
+	};
+	
+	VERIFY_TEST( parse( {} ).error == arrrgh::parse_error::none );
+	VERIFY_TEST( mode.value() == compression::none );
+	VERIFY_TEST( parse( { "--compression=zstd", "--fallbacks=lz4", "--fallbacks=none" } ).error == arrrgh::parse_error::none );
+	VERIFY_TEST( mode.value() == compression::zstd );
+	VERIFY_TEST( fallbacks.value() == ( std::vector< compression >{ compression::lz4, compression::none } ));
+	VERIFY_TEST( parse( { "-z=lz4" } ).error == arrrgh::parse_error::none );
+	VERIFY_TEST( mode.value() == compression::lz4 );
+	
+	// Names match exactly, and a miss lists them.
+	//
+	const auto status = parse( { "--compression=gzip" } );
+	VERIFY_TEST( status.error == arrrgh::parse_error::value_conversion );
+	VERIFY_EQUAL( parser.error_message( status ),
+				  "Could not convert value 'gzip' to the desired argument type. Expected one of zstd|lz4|none." );
+	VERIFY_TEST( parse( { "--compression=ZSTD" } ).error == arrrgh::parse_error::value_conversion );
+	VERIFY_TEST( parse( { "--compression=zst" } ).error == arrrgh::parse_error::value_conversion );
+	VERIFY_TEST( parse( { "--compression" } ).error == arrrgh::parse_error::missing_value );
+	VERIFY_TEST( parse( { "--fallbacks=lz4", "--fallbacks=snappy" } ).error == arrrgh::parse_error::value_conversion );
+	
+	std::ostringstream usage;
+	parser.show_usage( usage );
+	VERIFY_TEST( usage.str().find( "--compression=<zstd|lz4|none>" ) != std::string::npos );
+	
+	// static_parser takes them too.
+	//
+	arrrgh::static_parser< staticCompression > staticParser( "choices", "Tests enum options." );
+	const char* argv[] = { "choices", "-z=none" };
+	staticParser.parse( 2, argv );
+	VERIFY_TEST( staticParser.value< staticCompression >() == compression::none );
+	try
+	{
+		const char* bad[] = { "choices", "--compression=brotli" };
+		staticParser.clear_values();
+		staticParser.parse( 2, bad );
+		std::cout << "Test failed: invalid choice failed to fail." << std::endl;
+	}
+	catch( const std::exception& e )
+	{
+		VERIFY_EQUAL( std::string( e.what() ),
+					  "Could not convert value 'brotli' to the desired argument type. Expected one of zstd|lz4|none." );
+	}
+}
+
+void testSavedValues()
+{
+	struct arguments
+	{
+		const arrrgh::argument< int >& jobs;
+		const arrrgh::argument< std::vector< double >>& weights;
+		const arrrgh::argument< std::string >& name;
+		const arrrgh::argument< std::vector< std::string >>& include;
+		const arrrgh::argument< bool >& verbose;
+		const arrrgh::argument< compression >& mode;
+	};
+	
+	const auto addArguments = []( arrrgh::parser& parser )
+	{
+		return arguments{ parser.add< int >( "jobs", "Jobs.", 'j', arrrgh::Required ),
+						  parser.add< std::vector< double >>( "weights", "Weights." ),
+						  parser.add< std::string >( "name", "Name." ),
+						  parser.add< std::vector< std::string >>( "include", "Include.", 'I' ),
+						  parser.add< bool >( "verbose", "Verbose.", 'v' ),
+						  parser.add< compression >( "compression", "Compression." ) };
+	};
+	
+	arrrgh::parser supervisor( "saved", "Tests saved values." );
+	addArguments( supervisor );
+	const char* argv[] = { "saved", "-j=12", "--weights=1.5,-2", "--name=Absolom, Absolom", "-I=a", "unlabeled",
+						   "-I=b c", "-v", "--compression=lz4", "--", "--weirdly-unlabeled" };
+	supervisor.parse( 11, argv );
+	const std::string saved = supervisor.saved_values();
+	
+	arrrgh::parser worker( "saved", "Tests saved values." );
+	const arguments loaded = addArguments( worker );
+	
+	const auto check = [&]()
+	{
+		VERIFY_EQUAL( loaded.jobs.value(), 12 );
+		VERIFY_TEST( loaded.weights.value() == ( std::vector< double >{ 1.5, -2 } ));
+		VERIFY_EQUAL( loaded.name.value(), "Absolom, Absolom" );
+		VERIFY_TEST( loaded.include.value() == ( std::vector< std::string >{ "a", "b c" } ));
+		VERIFY_TEST( loaded.verbose.value() );
+		VERIFY_TEST( loaded.mode.value() == compression::lz4 );
+		VERIFY_EQUAL( loaded.jobs.value_string(), "12" );
+		
+		std::vector< std::string > unlabeled;
+		worker.each_unlabeled_argument( [&]( const std::string& arg ) { unlabeled.push_back( arg ); } );
+		VERIFY_TEST( unlabeled == ( std::vector< std::string >{ "unlabeled", "--weirdly-unlabeled" } ));
+	};
+	
+	VERIFY_TEST( worker.try_load_values( saved ));
+	check();
+	
+	// Borrowed, and from a file descriptor.
+	//
+	worker.clear_values();
+	VERIFY_TEST( worker.try_load_values( saved, arrrgh::Borrow ));
+	check();
+	
+#if !defined( _WIN32 )
+	std::FILE* const file = std::tmpfile();
+	std::fwrite( saved.data(), 1, saved.size(), file );
+	std::fflush( file );
+	worker.clear_values();
+	worker.load_values( fileno( file ));
+	check();
+	std::fclose( file );
+#endif
+	
+	// A larger region, such as shared memory, is fine.
+	//
+	worker.clear_values();
+	VERIFY_TEST( worker.try_load_values( saved + std::string( 4096, '\0' )));
+	check();
+	
+	// Different arguments are refused.
+	//
+	arrrgh::parser other( "saved", "Tests saved values." );
+	addArguments( other );
+	other.add< int >( "threads", "Threads." );
+	auto status = other.try_load_values( saved );
+	VERIFY_TEST( status.error == arrrgh::parse_error::mismatched_saved_values );
+	VERIFY_EQUAL( other.error_message( status ), "Saved values are for different arguments than this program's." );
+	try
+	{
+		other.load_values( saved );
+		std::cout << "Test failed: mismatched saved values failed to fail." << std::endl;
+	}
+	catch( const arrrgh::parser::MismatchedSavedValues& )
+	{}
+	
+	// So is anything truncated or damaged, without assigning any of it.
+	//
+	for( size_t length = 0; length < saved.size(); ++length )
+	{
+		worker.clear_values();
+		VERIFY_TEST( worker.try_load_values( saved.substr( 0, length )).error == arrrgh::parse_error::unreadable_saved_values );
+	}
+	
+	for( size_t i = 0; i < saved.size(); ++i )
+	{
+		std::string damaged = saved;
+		damaged[ i ] ^= 0x5a;
+		worker.clear_values();
+		status = worker.try_load_values( damaged );
+		if( status.error == arrrgh::parse_error::unreadable_saved_values )
+		{
+			VERIFY_TEST( !loaded.jobs.assigned() );
+		}
+	}
+}
+
+void testLiveOptions()
+{
+	arrrgh::schema schema( "live", "Tests publishing new options to running threads." );
+	
+	const auto& argThreads = schema.add< int >( "threads", "Threads.", 't', arrrgh::Optional, 1 );
+	const auto& argLevel = schema.add< std::string >( "log-level", "Log level.", 'l', arrrgh::Optional, "info" );
+	const auto& argFast = schema.add< bool >( "fast", "Fast.", 'f' );
+	
+	const char* first[] = { "live", "--threads=4", "input" };
+	arrrgh::live_options options( schema, 3, first );
+	
+	auto reader = options.make_reader();
+	{
+		const auto current = reader.read();
+		VERIFY_EQUAL( current->value( argThreads ), 4 );
+		VERIFY_EQUAL( current->value( argLevel ), "info" );
+		VERIFY_EQUAL( current->unlabeled_arguments()[ 0 ], "input" );
+		VERIFY_EQUAL( current->generation(), 1u );
+	}
+	
+	// Only what differs is reported, whether set or defaulted; a snapshot read before stays as it was.
+	//
+	{
+		const auto before = options.make_reader();
+		const auto held = before.read();
+		
+		std::string level = "--log-level=debug";
+		const char* second[] = { "live", "--threads=4", level.c_str(), "-f" };
+		const auto changed = options.reconfigure( 4, second );
+		level.assign( "--log-level=error" );
+		
+		VERIFY_EQUAL( changed.size(), 2u );
+		VERIFY_TEST( changed[ 0 ] == &argLevel && changed[ 1 ] == &argFast );
+		VERIFY_EQUAL( held->value( argLevel ), "info" );
+		VERIFY_EQUAL( options.unreclaimed(), 1u );
+		
+		const auto current = reader.read();
+		VERIFY_EQUAL( current->value( argLevel ), "debug" );
+		VERIFY_TEST( current->value( argFast ));
+		VERIFY_EQUAL( current->generation(), 2u );
+	}
+	
+	const char* third[] = { "live", "--log-level=debug" };
+	const auto changed = options.reconfigure( 2, third );
+	VERIFY_EQUAL( changed.size(), 2u );
+	VERIFY_TEST( changed[ 0 ] == &argThreads && changed[ 1 ] == &argFast );
+	VERIFY_EQUAL( options.unreclaimed(), 0u );
+	
+	// EXPECT FAILURE: A bad command line leaves the last snapshot in place.
+	//
+	try
+	{
+		const char* bad[] = { "live", "--threads=lots" };
+		options.reconfigure( 2, bad );
+		std::cout << "Test failed: bad reconfiguration failed to fail." << std::endl;
+	}
+	catch( const arrrgh::argument< int >::ValueConversionError& e )
+	{
+		if( VERBOSE ) std::cerr << "Error parsing arguments: " << e.what() << std::endl;
+	}
+	VERIFY_EQUAL( reader.read()->generation(), 3u );
+	
+	// Readers always see one whole snapshot while a writer keeps replacing it.
+	//
+	const char* consistent[] = { "live", "--threads=0", "--log-level=0" };
+	options.reconfigure( 3, consistent );
+	
+	std::atomic< bool > done{ false };
+	std::atomic< int > inconsistencies{ 0 };
+	std::vector< std::thread > readers;
+	for( int t = 0; t < 4; ++t )
+	{
+		readers.emplace_back( [&]()
+		{
+			const auto threadReader = options.make_reader();
+			while( !done )
+			{
+				const auto current = threadReader.read();
+				if( current->value( argLevel ) != std::to_string( current->value( argThreads ) * 2 ))
+				{
+					++inconsistencies;
+				}
+			}
+		} );
+	}
+	
+	for( int i = 0; i < 2000; ++i )
+	{
+		const std::string threads = "--threads=" + std::to_string( i );
+		const std::string level = "--log-level=" + std::to_string( i * 2 );
+		const char* argv[] = { "live", threads.c_str(), level.c_str() };
+		options.reconfigure( 3, argv );
+	}
+	done = true;
+	for( auto& thread : readers )
+	{
+		thread.join();
+	}
+	
+	VERIFY_EQUAL( inconsistencies.load(), 0 );
+	VERIFY_EQUAL( reader.read()->value( argThreads ), 1999 );
+	
+	const char* last[] = { "live" };
+	options.reconfigure( 1, last );
+	VERIFY_EQUAL( options.unreclaimed(), 0u );
+}
+
 int main( int argc, const char* argv[] )
 {
 	testProgramWithNoArgs();
@@ -447,6 +2288,30 @@ int main( int argc, const char* argv[] )
 	testOptionalNumericArg();
 	testUnlabeledArgs();
 	testEverything( true /* with equal sign */ );
+	testManyArgs();
+	testStaticParser();
+	testConversions();
+	testArgumentOwnership();
+	testAddFailure();
+	testSteadyStateAllocations();
+	testBatch();
+	testSharedSchema();
+	testTokenizer();
+	testResponseFiles();
+	testStreamingUnlabeledArgs();
+	testStats();
+	testMissingRequiredArgs();
+	testTryParse();
+	testMultiValueArgs();
+	testNumberLists();
+	testSubcommands();
+	testEnvironment();
+	testConfigFile();
+	testAbbreviationsAndCompletion();
+	testSuggestions();
+	testChoices();
+	testSavedValues();
+	testLiveOptions();
 
 	std::cout << "Done.\n";
 	
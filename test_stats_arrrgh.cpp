@@ -0,0 +1,77 @@
+//
+//  test_stats_arrrgh.cpp
+//
+//  Tests parse instrumentation, which is compiled in only with ARRRGH_ENABLE_STATS, so it has a program of its
+//  own and test_arrrgh.cpp covers the default build.
+//
+//		c++ -std=c++17 test_stats_arrrgh.cpp -o test_stats_arrrgh && ./test_stats_arrrgh
+//
+
+#define ARRRGH_ENABLE_STATS 1
+#include "arrrgh.hpp"
+#include <cstring>
+#include <iostream>
+
+namespace
+{
+	const bool VERBOSE = true;
+}
+
+#define VERIFY_TEST( expr )	if( !(expr) ) std::cout << "Test failed: " << #expr << std::endl;
+#define VERIFY_EQUAL( exprA, exprB )	if( !( (exprA) == (exprB) )) std::cout << "Test failed: \"" << (exprA) << "\" != \"" << (exprB) << "\"" << std::endl;
+
+void testStats()
+{
+	arrrgh::parser parser( "stats", "Tests parse instrumentation." );
+	
+	parser.add< int >( "count", "c.", 'c' );
+	parser.add< bool >( "fast", "f.", 'f' );
+	parser.add< bool >( "slow", "s.", 's' );
+	
+	const char* argv[] = { "stats", "--count=12", "-fs", "unlabeled" };
+	
+	parser.parse( 4, argv );
+	
+	const auto& stats = parser.stats();
+	VERIFY_EQUAL( stats.parses, 1u );
+	VERIFY_EQUAL( stats.tokens, 3u );
+	VERIFY_TEST( stats.lookupProbes >= 3 );
+	VERIFY_EQUAL( stats.bytesCopied, std::strlen( "stats--count=12-fsunlabeled" ) + 4 );
+	VERIFY_TEST( stats.allocations > 0 );
+	VERIFY_EQUAL( stats.conversionFailures, 0u );
+	VERIFY_TEST( stats.totalNanoseconds >= stats.lookupNanoseconds + stats.conversionNanoseconds );
+	
+	// After warm-up, parsing allocates nothing more; a bad value counts as a failed conversion.
+	//
+	parser.clear_values();
+	parser.reset_stats();
+	parser.parse( 4, argv );
+	VERIFY_EQUAL( stats.allocations, 0u );
+	
+	parser.clear_values();
+	const char* badValue[] = { "stats", "--count=twelve" };
+	try
+	{
+		parser.parse( 2, badValue );
+		std::cout << "Test failed: stats failed to fail." << std::endl;
+	}
+	catch( const std::exception& e )
+	{
+		if( VERBOSE ) std::cerr << "Error parsing arguments: " << e.what() << std::endl;
+	}
+	
+	VERIFY_EQUAL( parser.stats().parses, 2u );
+	VERIFY_EQUAL( parser.stats().conversionFailures, 1u );
+	
+	parser.reset_stats();
+	VERIFY_EQUAL( parser.stats().tokens, 0u );
+}
+
+int main()
+{
+	testStats();
+
+	std::cout << "Done.\n";
+	
+	return 0;
+}